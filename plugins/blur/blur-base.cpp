@@ -7,6 +7,7 @@
 #include <wayfire/output.hpp>
 #include <wayfire/workspace-set.hpp>
 #include <wayfire/util/log.hpp>
+#include <cmath>
 
 static const char *blur_blend_vertex_shader =
     R"(
@@ -218,8 +219,92 @@ static wf::pointf_t get_center(wf::geometry_t g)
     return {g.x + g.width / 2.0, g.y + g.height / 2.0};
 }
 
+void wf_blur_base::update_cache(blur_cache_t& cache, const wf::render_target_t& target,
+    wf::geometry_t box, const wf::region_t& region)
+{
+    int degrade = degrade_opt;
+    box = sanitize(box, degrade, target.framebuffer_box_from_geometry_box(target.geometry));
+    if ((box != cache.geometry) || (degrade != cache.degrade))
+    {
+        cache.geometry = box;
+        cache.degrade  = degrade;
+        cache.valid.clear();
+    }
+
+    if ((box.width <= 0) || (box.height <= 0))
+    {
+        return;
+    }
+
+    const int width  = std::max(box.width / degrade, 1);
+    const int height = std::max(box.height / degrade, 1);
+    const wf::geometry_t& src = prepared_geometry;
+
+    // Both buffers hold their box in GL orientation, so y is measured from the
+    // bottom edge of the box. Pixels of the cache which are only partially
+    // covered by the region are skipped.
+    const double dst_scale_x = 1.0 * width / box.width;
+    const double dst_scale_y = 1.0 * height / box.height;
+    const double src_scale_x = 1.0 * fb[0].viewport_width / src.width;
+    const double src_scale_y = 1.0 * fb[0].viewport_height / src.height;
+
+    OpenGL::render_begin();
+    cache.fb.allocate(width, height);
+    GL_CALL(glBindFramebuffer(GL_READ_FRAMEBUFFER, fb[0].fb));
+    GL_CALL(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, cache.fb.fb));
+    for (const auto& b : region & src & box)
+    {
+        int dx1 = std::ceil((b.x1 - box.x) * dst_scale_x);
+        int dx2 = std::floor((b.x2 - box.x) * dst_scale_x);
+        int dy1 = std::ceil((box.y + box.height - b.y2) * dst_scale_y);
+        int dy2 = std::floor((box.y + box.height - b.y1) * dst_scale_y);
+        if ((dx1 >= dx2) || (dy1 >= dy2))
+        {
+            continue;
+        }
+
+        // The copied pixels, in framebuffer coordinates
+        double x1 = box.x + dx1 / dst_scale_x;
+        double x2 = box.x + dx2 / dst_scale_x;
+        double y1 = box.y + box.height - dy2 / dst_scale_y;
+        double y2 = box.y + box.height - dy1 / dst_scale_y;
+
+        GL_CALL(glBlitFramebuffer(
+            std::lround((x1 - src.x) * src_scale_x),
+            std::lround((src.y + src.height - y2) * src_scale_y),
+            std::lround((x2 - src.x) * src_scale_x),
+            std::lround((src.y + src.height - y1) * src_scale_y),
+            dx1, dy1, dx2, dy2,
+            GL_COLOR_BUFFER_BIT, GL_LINEAR));
+
+        cache.valid |= wf::geometry_t{
+            (int)std::ceil(x1), (int)std::ceil(y1),
+            (int)std::floor(x2) - (int)std::ceil(x1),
+            (int)std::floor(y2) - (int)std::ceil(y1),
+        };
+    }
+
+    OpenGL::render_end();
+}
+
 void wf_blur_base::render(wf::texture_t src_tex, wlr_box src_box, const wf::region_t& damage,
     const wf::render_target_t& background_source_fb, const wf::render_target_t& target_fb)
+{
+    render_with_background(src_tex, src_box, damage, background_source_fb, target_fb,
+        fb[0].tex, prepared_geometry);
+}
+
+void wf_blur_base::render(wf::texture_t src_tex, wlr_box src_box, const wf::region_t& damage,
+    const wf::render_target_t& background_source_fb, const wf::render_target_t& target_fb,
+    const blur_cache_t& cache)
+{
+    render_with_background(src_tex, src_box, damage, background_source_fb, target_fb,
+        cache.fb.tex, cache.geometry);
+}
+
+void wf_blur_base::render_with_background(wf::texture_t src_tex, wlr_box src_box,
+    const wf::region_t& damage, const wf::render_target_t& background_source_fb,
+    const wf::render_target_t& target_fb, GLuint background_tex, wf::geometry_t background_geometry)
 {
     OpenGL::render_begin(target_fb);
     blend_program.use(src_tex.type);
@@ -253,8 +338,8 @@ void wf_blur_base::render(wf::texture_t src_tex, wlr_box src_box, const wf::regi
     // 3. Scale to match the view size
     // 4. Translate to match the view
     auto view_box    = background_source_fb.framebuffer_box_from_geometry_box(src_box); // Projected view
-    auto blurred_box = prepared_geometry;
-    // prepared_geometry is the projected damage bounding box
+    auto blurred_box = background_geometry;
+    // background_geometry is the projected damage bounding box
 
     glm::mat4 fb_fix   = target_fb.transform;
     const auto scale_x = 1.0 * view_box.width / blurred_box.width;
@@ -277,7 +362,7 @@ void wf_blur_base::render(wf::texture_t src_tex, wlr_box src_box, const wf::regi
 
     blend_program.set_active_texture(src_tex);
     GL_CALL(glActiveTexture(GL_TEXTURE0 + 1));
-    GL_CALL(glBindTexture(GL_TEXTURE_2D, fb[0].tex));
+    GL_CALL(glBindTexture(GL_TEXTURE_2D, background_tex));
     /* Render it to target_fb */
     target_fb.bind();
 
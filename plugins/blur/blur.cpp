@@ -6,6 +6,7 @@
 #include <wayfire/view.hpp>
 #include <wayfire/matcher.hpp>
 #include <wayfire/output.hpp>
+#include <wayfire/render-manager.hpp>
 #include <wayfire/view-transform.hpp>
 #include <wayfire/workspace-stream.hpp>
 #include <wayfire/workspace-set.hpp>
@@ -52,17 +53,6 @@ class blur_node_t : public transformer_base_node_t
         this->provider = provider;
     }
 
-    ~blur_node_t()
-    {
-        OpenGL::render_begin();
-        for (auto& buffer : saved_pixels)
-        {
-            buffer.pixels.release();
-        }
-
-        OpenGL::render_end();
-    }
-
     std::string stringify() const override
     {
         return "blur";
@@ -70,43 +60,146 @@ class blur_node_t : public transformer_base_node_t
 
     void gen_render_instances(std::vector<render_instance_uptr>& instances,
         damage_callback push_damage, wf::output_t *shown_on) override;
+};
 
-    struct saved_pixels_t
+class blur_render_instance_t : public transformer_render_instance_t<blur_node_t>
+{
+    // Pixels around the damage which have to be restored after blurring, see
+    // schedule_instructions(). The buffer comes from the shared framebuffer
+    // pool and covers only the bounding box of the saved region.
+    struct
     {
         wf::framebuffer_t pixels;
+        // The saved region, in framebuffer coordinates
         wf::region_t region;
-        bool taken = false;
+        // The part of the target framebuffer stored in pixels
+        wf::geometry_t box;
+    } saved_pixels;
+
+    void release_saved_pixels()
+    {
+        saved_pixels.region.clear();
+        OpenGL::release_pooled_framebuffer(saved_pixels.pixels);
+    }
+
+    // The blurred background of previous frames. It is kept only for the main
+    // render pass of the output, and only for the parts of the background
+    // which did not change since they were blurred.
+    blur_cache_t cache;
+    // Whether the cache is kept for the current render target
+    bool cache_enabled = false;
+    bool render_from_cache = false;
+
+    // The state for which the cache was computed. If any of it changes, the
+    // cache is dropped.
+    wf::geometry_t cache_bbox = {0, 0, 0, 0};
+    float cache_scale = 0;
+    wl_output_transform cache_transform = WL_OUTPUT_TRANSFORM_NORMAL;
+    wf::region_t cache_opaque_region;
+    wf_blur_base *cache_algorithm = nullptr;
+
+    // Damage on the output since the last frame which did not come from the
+    // view itself, and thus might have changed the background.
+    wf::region_t foreign_damage;
+    bool pushing_own_damage = false;
+
+    wf::signal::connection_t<wf::output_damage_signal> on_output_damage =
+        [=] (wf::output_damage_signal *ev)
+    {
+        if (!pushing_own_damage)
+        {
+            foreign_damage |= ev->region;
+        }
     };
 
-    std::list<saved_pixels_t> saved_pixels;
-    saved_pixels_t *acquire_saved_pixel_buffer()
+    wf::signal::connection_t<root_node_update_signal> on_root_update = [=] (root_node_update_signal *ev)
     {
-        auto it = std::find_if(saved_pixels.begin(), saved_pixels.end(),
-            [] (const saved_pixels_t& buffer) { return !buffer.taken; });
+        // Nodes below might have been added, removed or restacked
+        if (ev->flags & (update_flag::CHILDREN_LIST | update_flag::ENABLED | update_flag::GEOMETRY))
+        {
+            cache.valid.clear();
+        }
+    };
 
-        if (it != saved_pixels.end())
+    wf::region_t get_opaque_region()
+    {
+        if (self->get_children().size() == 1)
         {
-            it->taken = true;
-            return &(*it);
+            if (auto opaque = dynamic_cast<opaque_region_node_t*>(self->get_children().front().get()))
+            {
+                return opaque->get_opaque_region();
+            }
         }
 
-        saved_pixels.emplace_back();
-        saved_pixels.back().taken = true;
-        return &saved_pixels.back();
+        return {};
     }
 
-    void release_saved_pixel_buffer(saved_pixels_t *buffer)
+    /**
+     * Drop the parts of the cache which are no longer valid.
+     *
+     * @return Whether the cache can be used for the given render target.
+     */
+    bool update_cache_state(const wf::render_target_t& target, int padding)
     {
-        buffer->taken = false;
-    }
-};
+        // The cache is only valid for the main render pass of the output, because the foreign damage is
+        // collected in output coordinates. Other passes with the same geometry (for example workspace streams
+        // of the current workspace) render to their own buffers.
+        if (!_shown_on || (target.fb != _shown_on->render->get_target_framebuffer().fb) ||
+            target.subbuffer || (target.geometry != _shown_on->get_relative_geometry()))
+        {
+            return false;
+        }
 
-class blur_render_instance_t : public transformer_render_instance_t<blur_node_t>
-{
-    blur_node_t::saved_pixels_t *saved_pixels = nullptr;
+        auto bbox = self->get_bounding_box();
+        auto opaque_region = get_opaque_region();
+        if ((bbox != cache_bbox) || (target.scale != cache_scale) ||
+            (target.wl_transform != cache_transform) || (self->provider() != cache_algorithm) ||
+            !(opaque_region ^ cache_opaque_region).empty() || !(cache_opaque_region ^ opaque_region).empty())
+        {
+            cache.valid.clear();
+            cache_bbox  = bbox;
+            cache_scale = target.scale;
+            cache_transform = target.wl_transform;
+            cache_algorithm = self->provider();
+            cache_opaque_region = opaque_region;
+        }
+
+        // Changed pixels affect the blurred background in the blur radius around them
+        foreign_damage.expand_edges(padding);
+        cache.valid ^= target.framebuffer_region_from_geometry_region(foreign_damage);
+        foreign_damage.clear();
+        return true;
+    }
 
   public:
-    using transformer_render_instance_t::transformer_render_instance_t;
+    blur_render_instance_t(blur_node_t *self, damage_callback push_damage, wf::output_t *shown_on) :
+        transformer_render_instance_t(self, push_damage, shown_on)
+    {
+        // Damage from the view passes through here before reaching the output,
+        // so we can tell it apart from changes to the background.
+        this->_push_damage = [=] (const wf::region_t& region)
+        {
+            pushing_own_damage = true;
+            push_damage(region);
+            pushing_own_damage = false;
+        };
+
+        if (shown_on)
+        {
+            shown_on->connect(&on_output_damage);
+        }
+
+        wf::get_core().scene()->connect(&on_root_update);
+    }
+
+    ~blur_render_instance_t()
+    {
+        OpenGL::render_begin();
+        cache.release();
+        release_saved_pixels();
+        OpenGL::render_end();
+    }
+
     bool is_fully_opaque(wf::region_t damage)
     {
         if (self->get_children().size() == 1)
@@ -166,6 +259,25 @@ class blur_render_instance_t : public transformer_render_instance_t<blur_node_t>
             return;
         }
 
+        // If the background was blurred in an earlier frame and did not change
+        // since then, the cached blurred background can be used. In this case,
+        // there are no artifacts to hide, so the damage doesn't need padding.
+        cache_enabled = update_cache_state(target, padding);
+        if (cache_enabled)
+        {
+            auto translucent = calculate_translucent_damage(target, padded_region & target.geometry);
+            if ((target.framebuffer_region_from_geometry_region(translucent) ^ cache.valid).empty())
+            {
+                render_from_cache = true;
+                instructions.push_back(render_instruction_t{
+                            .instance = this,
+                            .target   = target,
+                            .damage   = padded_region & target.geometry,
+                        });
+                return;
+            }
+        }
+
         padded_region.expand_edges(padding);
         padded_region &= bbox;
 
@@ -177,27 +289,32 @@ class blur_render_instance_t : public transformer_render_instance_t<blur_node_t>
         // Actual region which will be repainted by this render instance.
         wf::region_t we_repaint = padded_region;
 
-        this->saved_pixels   = self->acquire_saved_pixel_buffer();
-        saved_pixels->region =
+        OpenGL::render_begin();
+        release_saved_pixels();
+        saved_pixels.region =
             target.framebuffer_region_from_geometry_region(padded_region) ^
             target.framebuffer_region_from_geometry_region(damage);
+        saved_pixels.box = wlr_box_from_pixman_box(saved_pixels.region.get_extents());
 
         // Nodes below should re-render the padded areas so that we can sample from them
         damage |= padded_region;
 
-        OpenGL::render_begin();
-        saved_pixels->pixels.allocate(target.viewport_width, target.viewport_height);
-        saved_pixels->pixels.bind();
-        GL_CALL(glBindFramebuffer(GL_READ_FRAMEBUFFER, target.fb));
-
-        /* Copy pixels in padded_region from target_fb to saved_pixels. */
-        for (const auto& box : saved_pixels->region)
+        if (!saved_pixels.region.empty())
         {
-            GL_CALL(glBlitFramebuffer(
-                box.x1, target.viewport_height - box.y2,
-                box.x2, target.viewport_height - box.y1,
-                box.x1, box.y1, box.x2, box.y2,
-                GL_COLOR_BUFFER_BIT, GL_LINEAR));
+            const auto& sbox = saved_pixels.box;
+            saved_pixels.pixels = OpenGL::acquire_pooled_framebuffer(sbox.width, sbox.height);
+            saved_pixels.pixels.bind();
+            GL_CALL(glBindFramebuffer(GL_READ_FRAMEBUFFER, target.fb));
+
+            /* Copy pixels in padded_region from target_fb to saved_pixels. */
+            for (const auto& box : saved_pixels.region)
+            {
+                GL_CALL(glBlitFramebuffer(
+                    box.x1, target.viewport_height - box.y2,
+                    box.x2, target.viewport_height - box.y1,
+                    box.x1 - sbox.x, box.y1 - sbox.y, box.x2 - sbox.x, box.y2 - sbox.y,
+                    GL_COLOR_BUFFER_BIT, GL_LINEAR));
+            }
         }
 
         OpenGL::render_end();
@@ -212,11 +329,26 @@ class blur_render_instance_t : public transformer_render_instance_t<blur_node_t>
     {
         auto tex = get_texture(target.scale);
         auto bounding_box = self->get_bounding_box();
+        if (render_from_cache)
+        {
+            render_from_cache = false;
+            self->provider()->render(tex, bounding_box, damage, target, target, cache);
+            return;
+        }
+
         if (!damage.empty())
         {
             auto translucent_damage = calculate_translucent_damage(target, damage);
             self->provider()->prepare_blur(target, translucent_damage);
             self->provider()->render(tex, bounding_box, damage, target, target);
+
+            if (cache_enabled)
+            {
+                // The padded parts of the damage have artifacts, keep only the rest.
+                auto blurred = target.framebuffer_region_from_geometry_region(translucent_damage);
+                self->provider()->update_cache(cache, target,
+                    target.framebuffer_box_from_geometry_box(bounding_box), blurred ^ saved_pixels.region);
+            }
         }
 
         OpenGL::render_begin(target);
@@ -224,22 +356,24 @@ class blur_render_instance_t : public transformer_render_instance_t<blur_node_t>
         // rendered with expanded damage and artifacts on the edges.
         // saved_pixels has the the padded region of pixels to overwrite the
         // artifacts that blurring has left behind.
-        GL_CALL(glBindFramebuffer(GL_READ_FRAMEBUFFER, saved_pixels->pixels.fb));
-
-        /* Copy pixels back from saved_pixels to target_fb. */
-        for (const auto& box : saved_pixels->region)
+        if (!saved_pixels.region.empty())
         {
-            GL_CALL(glBlitFramebuffer(
-                box.x1, box.y1, box.x2, box.y2,
-                box.x1, target.viewport_height - box.y2,
-                box.x2, target.viewport_height - box.y1,
-                GL_COLOR_BUFFER_BIT, GL_LINEAR));
+            GL_CALL(glBindFramebuffer(GL_READ_FRAMEBUFFER, saved_pixels.pixels.fb));
+
+            /* Copy pixels back from saved_pixels to target_fb. */
+            const auto& sbox = saved_pixels.box;
+            for (const auto& box : saved_pixels.region)
+            {
+                GL_CALL(glBlitFramebuffer(
+                    box.x1 - sbox.x, box.y1 - sbox.y, box.x2 - sbox.x, box.y2 - sbox.y,
+                    box.x1, target.viewport_height - box.y2,
+                    box.x2, target.viewport_height - box.y1,
+                    GL_COLOR_BUFFER_BIT, GL_LINEAR));
+            }
         }
 
         /* Reset stuff */
-        saved_pixels->region.clear();
-        self->release_saved_pixel_buffer(saved_pixels);
-        saved_pixels = NULL;
+        release_saved_pixels();
         OpenGL::render_end();
     }
 
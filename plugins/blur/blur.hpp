@@ -88,6 +88,29 @@
  * `````````````````````````````````````````````````````````````````
  */
 
+/**
+ * A copy of the blurred background behind a view, which can be reused in later
+ * frames as long as the background does not change.
+ */
+struct blur_cache_t
+{
+    /* The blurred background, degraded the same way as during blurring */
+    wf::framebuffer_t fb;
+    /* The box covered by fb, in framebuffer coordinates */
+    wf::geometry_t geometry = {0, 0, 0, 0};
+    /* The degrade value used for fb */
+    int degrade = 0;
+    /* The region where fb contains an up-to-date blurred background, in
+     * framebuffer coordinates */
+    wf::region_t valid;
+
+    void release()
+    {
+        fb.release();
+        valid.clear();
+    }
+};
+
 class wf_blur_base
 {
   protected:
@@ -127,6 +150,12 @@ class wf_blur_base
      * returns the index of the fb where the result is stored (0 or 1) */
     virtual int blur_fb0(const wf::region_t& blur_region, int width, int height) = 0;
 
+    /* render with the given blurred background, whose texture covers
+     * background_geometry (in framebuffer coords) */
+    void render_with_background(wf::texture_t src_tex, wlr_box src_box, const wf::region_t& damage,
+        const wf::render_target_t& background_source_fb, const wf::render_target_t& target_fb,
+        GLuint background_tex, wf::geometry_t background_geometry);
+
   public:
     wf_blur_base(std::string name);
     virtual ~wf_blur_base();
@@ -152,6 +181,28 @@ class wf_blur_base
      */
     void render(wf::texture_t src_tex, wlr_box src_box, const wf::region_t& damage,
         const wf::render_target_t& background_source_fb, const wf::render_target_t& target_fb);
+
+    /**
+     * Same as render(), but use the blurred background stored in @cache instead
+     * of the one prepared by @prepare_blur.
+     */
+    void render(wf::texture_t src_tex, wlr_box src_box, const wf::region_t& damage,
+        const wf::render_target_t& background_source_fb, const wf::render_target_t& target_fb,
+        const blur_cache_t& cache);
+
+    /**
+     * Copy a part of the background prepared by the last @prepare_blur call to
+     * the cache.
+     *
+     * @param cache The cache to update.
+     * @param target The render target which was passed to @prepare_blur.
+     * @param box The box which the cache should cover, in framebuffer coordinates.
+     *   If it changes, the cache is reset.
+     * @param region The region to copy, in framebuffer coordinates. It should
+     *   contain only pixels which were blurred without artifacts.
+     */
+    void update_cache(blur_cache_t& cache, const wf::render_target_t& target,
+        wf::geometry_t box, const wf::region_t& region);
 };
 
 std::unique_ptr<wf_blur_base> create_box_blur();
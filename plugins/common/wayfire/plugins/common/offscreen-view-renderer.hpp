@@ -0,0 +1,118 @@
+#pragma once
+
+#include <functional>
+#include <wayfire/region.hpp>
+#include <wayfire/scene.hpp>
+#include <wayfire/scene-render.hpp>
+
+namespace wf
+{
+/**
+ * A helper for plugins which render a node (typically a view's transformed node) outside of the normal
+ * scenegraph rendering, for example in the switcher or in scale.
+ *
+ * The render instances of the node are kept across frames instead of being generated for every render, and
+ * the damage they report is accumulated. The instances are regenerated only when the node's list of children
+ * changes.
+ */
+class offscreen_view_renderer_t
+{
+  public:
+    /**
+     * @param node The node to render.
+     * @param output The output the instances are generated for.
+     * @param on_damage An optional callback which is called whenever the node is damaged, for example to
+     *   schedule a redraw.
+     */
+    offscreen_view_renderer_t(wf::scene::node_ptr node, wf::output_t *output,
+        std::function<void(const wf::region_t&)> on_damage = {})
+    {
+        this->node = node;
+        this->output    = output;
+        this->on_damage = on_damage;
+    }
+
+    offscreen_view_renderer_t(const offscreen_view_renderer_t&) = delete;
+    offscreen_view_renderer_t& operator =(const offscreen_view_renderer_t&) = delete;
+
+    wf::scene::node_ptr get_node() const
+    {
+        return node;
+    }
+
+    /**
+     * Get the damage accumulated since the last render, in the coordinate system of the node's parent.
+     */
+    const wf::region_t& get_damage() const
+    {
+        return damage;
+    }
+
+    /**
+     * Render the whole node onto the target.
+     */
+    void render(const wf::render_target_t& target)
+    {
+        render(target, node->get_bounding_box());
+    }
+
+    /**
+     * Re-render only the parts of the node which were damaged since the last render. Useful if the target
+     * keeps its contents between renders, for example an auxiliary buffer.
+     */
+    void render_damaged(const wf::render_target_t& target)
+    {
+        render(target, damage);
+    }
+
+    /**
+     * Render the given region of the node onto the target and reset the accumulated damage.
+     */
+    void render(const wf::render_target_t& target, const wf::region_t& region)
+    {
+        ensure_instances();
+
+        wf::scene::render_pass_params_t params;
+        params.instances = &instances;
+        params.damage    = region;
+        params.reference_output = output;
+        params.target = target;
+        wf::scene::run_render_pass(params, 0);
+        damage.clear();
+    }
+
+  private:
+    wf::scene::node_ptr node;
+    wf::output_t *output;
+    std::function<void(const wf::region_t&)> on_damage;
+
+    std::vector<wf::scene::render_instance_uptr> instances;
+    uint64_t instances_generation = 0;
+    bool have_instances = false;
+    wf::region_t damage;
+
+    void ensure_instances()
+    {
+        // Changes deeper in the node are either handled by the render instances themselves, or propagate to
+        // the node as CHILDREN_LIST updates, which bump its generation.
+        if (have_instances && (instances_generation == node->get_instances_generation()))
+        {
+            return;
+        }
+
+        instances.clear();
+        node->gen_render_instances(instances, [=] (const wf::region_t& region)
+        {
+            damage |= region;
+            if (on_damage)
+            {
+                on_damage(region);
+            }
+        }, output);
+
+        instances_generation = node->get_instances_generation();
+        have_instances = true;
+        damage |= node->get_bounding_box();
+    }
+};
+}
@@ -94,6 +94,19 @@ class workspace_wall_t : public wf::signal::provider_t
      */
     void stop_output_renderer(bool reset_viewport);
 
+    /**
+     * Keep the workspace buffers after stop_output_renderer(), and keep collecting the damage of the
+     * workspaces while the wall is not shown. The next start_output_renderer() then only has to repaint the
+     * damaged parts of the workspaces instead of all of them. While the wall is not shown, each buffer is
+     * shrunk to the resolution at which its workspace was last rendered, for example the thumbnail size in
+     * Expo.
+     *
+     * @param memory_budget The maximal amount of memory (in bytes) for the kept buffers. Buffers which do not
+     *   fit are released, starting with the workspaces farthest from the current one. 0 disables keeping the
+     *   buffers.
+     */
+    void set_persistent_buffers(size_t memory_budget);
+
     /**
      * Calculate the geometry of a particular workspace, as described in
      * set_viewport().
@@ -129,5 +142,9 @@ class workspace_wall_t : public wf::signal::provider_t
   protected:
     class workspace_wall_node_t;
     std::shared_ptr<workspace_wall_node_t> render_node;
+
+    size_t persistent_memory_budget = 0;
+    // The node of the last stop_output_renderer(), kept with its buffers if persistent buffers are enabled
+    std::shared_ptr<workspace_wall_node_t> inactive_node;
 };
 }
@@ -9,6 +9,7 @@
 #include "wayfire/core.hpp"
 
 #include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
 
 namespace wf
 {
@@ -258,6 +259,7 @@ class workspace_wall_t::workspace_wall_node_t : public scene::node_t
     workspace_wall_node_t(workspace_wall_t *wall) : node_t(false)
     {
         this->wall  = wall;
+        this->wset  = wall->output->wset();
         auto [w, h] = wall->output->wset()->get_workspace_grid_size();
         workspaces.resize(w);
         for (int i = 0; i < w; i++)
@@ -267,21 +269,167 @@ class workspace_wall_t::workspace_wall_node_t : public scene::node_t
                 auto node = std::make_shared<workspace_stream_node_t>(
                     wall->output, wf::point_t{i, j});
                 workspaces[i].push_back(node);
+                allocate_buffer(i, j);
+            }
+        }
+    }
+
+    /**
+     * Check whether the buffers still match the workspace grid and the output, so that the node can be
+     * shown again after it was inactive.
+     */
+    bool is_compatible() const
+    {
+        if (wset.lock() != wall->output->wset())
+        {
+            return false;
+        }
+
+        auto [w, h] = wall->output->wset()->get_workspace_grid_size();
+        if ((int)workspaces.size() != w)
+        {
+            return false;
+        }
+
+        for (int i = 0; i < w; i++)
+        {
+            if ((int)workspaces[i].size() != h)
+            {
+                return false;
+            }
+
+            for (int j = 0; j < h; j++)
+            {
+                const auto& buffer = aux_buffers.at(i).at(j);
+                if ((buffer.geometry != workspaces[i][j]->get_bounding_box()) ||
+                    (buffer.scale != wall->output->handle->scale))
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * Start or stop collecting the damage of the workspaces while the node is not in the scenegraph.
+     */
+    void set_tracking_damage(bool track)
+    {
+        if (track)
+        {
+            for (auto& layer : wf::get_core().scene()->layers)
+            {
+                layer->connect(&on_layer_regen);
+            }
+
+            regen_tracking_instances();
+        } else
+        {
+            on_layer_regen.disconnect();
+            tracking_instances.clear();
+        }
+    }
+
+    /**
+     * Shrink the buffers to the part which was last rendered (the workspace thumbnails are usually rendered
+     * at a lower scale), and release the buffers which do not fit in the memory budget. The buffers of the
+     * workspaces closest to the current workspace are kept first.
+     */
+    void trim_buffers(size_t budget)
+    {
+        auto cws = wall->output->wset()->get_current_workspace();
+        std::vector<wf::point_t> order;
+        for (int i = 0; i < (int)workspaces.size(); i++)
+        {
+            for (int j = 0; j < (int)workspaces[i].size(); j++)
+            {
+                order.push_back({i, j});
+            }
+        }
+
+        auto distance = [&] (wf::point_t ws)
+        {
+            return std::abs(ws.x - cws.x) + std::abs(ws.y - cws.y);
+        };
+        std::stable_sort(order.begin(), order.end(), [&] (wf::point_t a, wf::point_t b)
+        {
+            return distance(a) < distance(b);
+        });
+
+        size_t used = 0;
+        OpenGL::render_begin();
+        for (auto ws : order)
+        {
+            auto& buffer    = aux_buffers[ws.x][ws.y];
+            auto& thumbnail = thumbnails[ws.x][ws.y];
+            if ((buffer.fb != (uint32_t)-1) && buffer.subbuffer &&
+                ((buffer.subbuffer->width < buffer.viewport_width) ||
+                 (buffer.subbuffer->height < buffer.viewport_height)))
+            {
+                shrink_buffer(buffer, thumbnail);
+            }
+
+            auto& kept = (buffer.fb != (uint32_t)-1) ? buffer : thumbnail;
+            if (kept.fb == (uint32_t)-1)
+            {
+                continue;
+            }
+
+            size_t size = 4ul * kept.viewport_width * kept.viewport_height;
+            if (used + size <= budget)
+            {
+                used += size;
+            } else
+            {
+                kept.release();
+            }
+        }
+
+        OpenGL::render_end();
+    }
 
-                aux_buffers[i][j].geometry = workspaces[i][j]->get_bounding_box();
-                aux_buffers[i][j].scale    = wall->output->handle->scale;
-                aux_buffers[i][j].wl_transform = WL_OUTPUT_TRANSFORM_NORMAL;
-                aux_buffers[i][j].transform    = get_output_matrix_from_transform(
-                    aux_buffers[i][j].wl_transform);
+    /** Allocate the buffers released or shrunk by trim_buffers() again. */
+    void restore_buffers()
+    {
+        for (int i = 0; i < (int)workspaces.size(); i++)
+        {
+            for (int j = 0; j < (int)workspaces[i].size(); j++)
+            {
+                if (aux_buffers[i][j].fb != (uint32_t)-1)
+                {
+                    continue;
+                }
+
+                auto& thumbnail = thumbnails[i][j];
+                if (thumbnail.fb == (uint32_t)-1)
+                {
+                    allocate_buffer(i, j);
+                    continue;
+                }
+
+                // Put the thumbnail back at the top-left of a full buffer, where the render instance expects
+                // the contents of a downscaled buffer. Only the damage collected so far has to be repainted.
+                auto damage = aux_buffer_damage[i][j];
+                auto scale  = aux_buffer_current_scale[i][j];
+                allocate_buffer(i, j);
+                aux_buffer_damage[i][j] = damage;
+                aux_buffer_current_scale[i][j] = scale;
+
+                auto& buffer = aux_buffers[i][j];
+                buffer.subbuffer = wf::geometry_t{0, 0, thumbnail.viewport_width, thumbnail.viewport_height};
 
-                auto size =
-                    aux_buffers[i][j].framebuffer_box_from_geometry_box(aux_buffers[i][j].geometry);
                 OpenGL::render_begin();
-                aux_buffers[i][j].allocate(size.width, size.height);
+                GL_CALL(glBindFramebuffer(GL_READ_FRAMEBUFFER, thumbnail.fb));
+                GL_CALL(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, buffer.fb));
+                GL_CALL(glBlitFramebuffer(
+                    0, 0, thumbnail.viewport_width, thumbnail.viewport_height,
+                    0, buffer.viewport_height - thumbnail.viewport_height,
+                    thumbnail.viewport_width, buffer.viewport_height,
+                    GL_COLOR_BUFFER_BIT, GL_NEAREST));
+                thumbnail.release();
                 OpenGL::render_end();
-
-                aux_buffer_damage[i][j] |= aux_buffers[i][j].geometry;
-                aux_buffer_current_scale[i][j] = 1.0;
             }
         }
     }
@@ -297,6 +445,14 @@ class workspace_wall_t::workspace_wall_node_t : public scene::node_t
             }
         }
 
+        for (auto& [_, buffers] : thumbnails)
+        {
+            for (auto& [_, buffer] : buffers)
+            {
+                buffer.release();
+            }
+        }
+
         OpenGL::render_end();
     }
 
@@ -327,12 +483,87 @@ class workspace_wall_t::workspace_wall_node_t : public scene::node_t
     workspace_wall_t *wall;
     std::vector<std::vector<std::shared_ptr<workspace_stream_node_t>>> workspaces;
 
+    void allocate_buffer(int i, int j)
+    {
+        aux_buffers[i][j] = {};
+        aux_buffers[i][j].geometry = workspaces[i][j]->get_bounding_box();
+        aux_buffers[i][j].scale    = wall->output->handle->scale;
+        aux_buffers[i][j].wl_transform = WL_OUTPUT_TRANSFORM_NORMAL;
+        aux_buffers[i][j].transform    = get_output_matrix_from_transform(
+            aux_buffers[i][j].wl_transform);
+
+        auto size =
+            aux_buffers[i][j].framebuffer_box_from_geometry_box(aux_buffers[i][j].geometry);
+        OpenGL::render_begin();
+        aux_buffers[i][j].allocate(size.width, size.height);
+        OpenGL::render_end();
+
+        aux_buffer_damage[i][j] |= aux_buffers[i][j].geometry;
+        aux_buffer_current_scale[i][j] = 1.0;
+    }
+
+    // The workspace set the buffers show
+    std::weak_ptr<wf::workspace_set_t> wset;
+
+    // Render instances of the workspaces, used only to collect damage while the node is inactive
+    per_workspace_map_t<std::vector<scene::render_instance_uptr>> tracking_instances;
+
+    void regen_tracking_instances()
+    {
+        tracking_instances.clear();
+        for (int i = 0; i < (int)workspaces.size(); i++)
+        {
+            for (int j = 0; j < (int)workspaces[i].size(); j++)
+            {
+                workspaces[i][j]->gen_render_instances(tracking_instances[i][j],
+                    [=] (const wf::region_t& damage) { aux_buffer_damage[i][j] |= damage; }, wall->output);
+            }
+        }
+    }
+
+    // The tracking instances are not part of the scenegraph, so they have to be regenerated together with the
+    // instances of the scenegraph. Layer nodes swallow the CHILDREN_LIST and ENABLED updates of their
+    // children and only regenerate their own instances, so those updates never reach the root. Nodes may have
+    // been added or removed without damage reaching the instances, so the buffers are repainted fully.
+    wf::signal::connection_t<scene::node_regen_instances_signal> on_layer_regen =
+        [=] (scene::node_regen_instances_signal*)
+    {
+        regen_tracking_instances();
+        for (auto& [i, column] : aux_buffers)
+        {
+            for (auto& [j, buffer] : column)
+            {
+                aux_buffer_damage[i][j] |= buffer.geometry;
+            }
+        }
+    };
+
+    /**
+     * Copy the rendered part (the subbuffer) of @buffer into @thumbnail and release @buffer.
+     * Must be called with the GL context bound.
+     */
+    static void shrink_buffer(wf::render_target_t& buffer, wf::framebuffer_t& thumbnail)
+    {
+        auto sub = buffer.subbuffer.value();
+        thumbnail.allocate(sub.width, sub.height);
+        GL_CALL(glBindFramebuffer(GL_READ_FRAMEBUFFER, buffer.fb));
+        GL_CALL(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, thumbnail.fb));
+        GL_CALL(glBlitFramebuffer(
+            sub.x, buffer.viewport_height - sub.y - sub.height,
+            sub.x + sub.width, buffer.viewport_height - sub.y,
+            0, 0, sub.width, sub.height,
+            GL_COLOR_BUFFER_BIT, GL_NEAREST));
+        buffer.release();
+    }
+
     // Buffers keeping the contents of almost-static workspaces
     per_workspace_map_t<wf::render_target_t> aux_buffers;
     // Damage accumulated for those buffers
     per_workspace_map_t<wf::region_t> aux_buffer_damage;
     // Current rendering scale for the workspace
     per_workspace_map_t<float> aux_buffer_current_scale;
+    // Downscaled copies of the buffers, kept instead of them while the wall is not shown
+    per_workspace_map_t<wf::framebuffer_t> thumbnails;
 };
 
 workspace_wall_t::workspace_wall_t(wf::output_t *_output) : output(_output)
@@ -343,6 +574,7 @@ workspace_wall_t::workspace_wall_t(wf::output_t *_output) : output(_output)
 workspace_wall_t::~workspace_wall_t()
 {
     stop_output_renderer(false);
+    inactive_node = nullptr;
 }
 
 void workspace_wall_t::set_background_color(const wf::color_t& color)
@@ -380,7 +612,17 @@ void workspace_wall_t::render_wall(
 void workspace_wall_t::start_output_renderer()
 {
     wf::dassert(render_node == nullptr, "Starting workspace-wall twice?");
-    render_node = std::make_shared<workspace_wall_node_t>(this);
+    if (inactive_node && inactive_node->is_compatible())
+    {
+        render_node = std::move(inactive_node);
+        render_node->set_tracking_damage(false);
+        render_node->restore_buffers();
+    } else
+    {
+        render_node = std::make_shared<workspace_wall_node_t>(this);
+    }
+
+    inactive_node = nullptr;
     scene::add_front(wf::get_core().scene(), render_node);
 }
 
@@ -392,6 +634,13 @@ void workspace_wall_t::stop_output_renderer(bool reset_viewport)
     }
 
     scene::remove_child(render_node);
+    if (persistent_memory_budget > 0)
+    {
+        render_node->trim_buffers(persistent_memory_budget);
+        render_node->set_tracking_damage(true);
+        inactive_node = std::move(render_node);
+    }
+
     render_node = nullptr;
 
     if (reset_viewport)
@@ -400,6 +649,21 @@ void workspace_wall_t::stop_output_renderer(bool reset_viewport)
     }
 }
 
+void workspace_wall_t::set_persistent_buffers(size_t memory_budget)
+{
+    this->persistent_memory_budget = memory_budget;
+    if (inactive_node)
+    {
+        if (memory_budget > 0)
+        {
+            inactive_node->trim_buffers(memory_budget);
+        } else
+        {
+            inactive_node = nullptr;
+        }
+    }
+}
+
 wf::geometry_t workspace_wall_t::get_workspace_rectangle(
     const wf::point_t& ws) const
 {
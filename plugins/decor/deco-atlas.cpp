@@ -0,0 +1,78 @@
+#include "deco-atlas.hpp"
+#include "deco-theme.hpp"
+#include <cmath>
+#include <wayfire/plugins/common/cairo-util.hpp>
+
+namespace wf
+{
+namespace decor
+{
+decoration_atlas_t::texture_ptr decoration_atlas_t::upload(cairo_surface_t *surface)
+{
+    auto texture = std::make_shared<wf::simple_texture_t>();
+    OpenGL::render_begin();
+    cairo_surface_upload_to_texture(surface, *texture);
+    OpenGL::render_end();
+    cairo_surface_destroy(surface);
+    return texture;
+}
+
+decoration_atlas_t::texture_ptr decoration_atlas_t::get_button(const decoration_theme_t& theme,
+    button_type_t type, double hover_progress)
+{
+    /**
+     * We render at 100% resolution
+     * When uploading the texture, this gets scaled
+     * to 70% of the titlebar height. Thus we will have
+     * a very crisp image
+     */
+    const int size = theme.get_title_height();
+    if (size != button_size)
+    {
+        // Buttons still in use keep their textures alive until they are updated.
+        buttons.clear();
+        button_size = size;
+    }
+
+    const int level = std::lround(hover_progress * HOVER_LEVELS);
+    auto& texture   = buttons[{type, level}];
+    if (!texture)
+    {
+        decoration_theme_t::button_state_t state = {
+            .width  = 1.0 * size,
+            .height = 1.0 * size,
+            .border = 1.0,
+            .hover_progress = 1.0 * level / HOVER_LEVELS,
+        };
+
+        texture = upload(theme.get_button_surface(type, state));
+    }
+
+    return texture;
+}
+
+decoration_atlas_t::texture_ptr decoration_atlas_t::get_title(const decoration_theme_t& theme,
+    const std::string& text, int height)
+{
+    auto key = std::make_tuple(text, theme.get_font(), height);
+    auto it  = titles.find(key);
+    if (it != titles.end())
+    {
+        if (auto texture = it->second.lock())
+        {
+            return texture;
+        }
+    }
+
+    // Drop titles which are no longer used by any decoration
+    for (auto jt = titles.begin(); jt != titles.end();)
+    {
+        jt = jt->second.expired() ? titles.erase(jt) : std::next(jt);
+    }
+
+    auto texture = upload(theme.render_text(text, height));
+    titles[key] = texture;
+    return texture;
+}
+}
+}
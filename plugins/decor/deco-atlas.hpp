@@ -0,0 +1,52 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <wayfire/plugins/common/simple-texture.hpp>
+#include "deco-button.hpp"
+
+namespace wf
+{
+namespace decor
+{
+class decoration_theme_t;
+
+/**
+ * A cache of the textures used by decorations, shared by all decorated views.
+ *
+ * Button textures are cached per button type and a quantized hover progress, so that hover animations
+ * reuse the same few textures instead of redrawing the button with cairo on every step. Title textures are
+ * cached by text, font and height, and are kept only as long as a decoration uses them.
+ *
+ * The atlas is meant to be accessed via wf::shared_data::ref_ptr_t.
+ */
+class decoration_atlas_t
+{
+  public:
+    using texture_ptr = std::shared_ptr<const wf::simple_texture_t>;
+
+    /** The number of hover levels per unit of hover progress */
+    static constexpr int HOVER_LEVELS = 16;
+
+    /**
+     * Get the texture of a button for the given hover progress, which is rounded to the closest hover
+     * level.
+     */
+    texture_ptr get_button(const decoration_theme_t& theme, button_type_t type, double hover_progress);
+
+    /**
+     * Get the texture of a title with the given height in pixels. The texture is as wide as the text.
+     */
+    texture_ptr get_title(const decoration_theme_t& theme, const std::string& text, int height);
+
+  private:
+    int button_size = 0;
+    std::map<std::tuple<button_type_t, int>, texture_ptr> buttons;
+    std::map<std::tuple<std::string, std::string, int>, std::weak_ptr<const wf::simple_texture_t>> titles;
+
+    static texture_ptr upload(cairo_surface_t *surface);
+};
+}
+}
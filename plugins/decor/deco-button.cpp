@@ -1,7 +1,7 @@
 #include "deco-button.hpp"
 #include "deco-theme.hpp"
+#include "deco-atlas.hpp"
 #include <wayfire/opengl.hpp>
-#include <wayfire/plugins/common/cairo-util.hpp>
 
 #define HOVERED  1.0
 #define NORMAL   0.0
@@ -15,6 +15,8 @@ button_t::button_t(const decoration_theme_t& t, std::function<void()> damage) :
     theme(t), damage_callback(damage)
 {}
 
+button_t::~button_t() = default;
+
 void button_t::set_button_type(button_type_t type)
 {
     this->type = type;
@@ -66,9 +68,14 @@ void button_t::set_pressed(bool is_pressed)
 void button_t::render(const wf::render_target_t& fb, wf::geometry_t geometry,
     wf::geometry_t scissor)
 {
+    if (!button_texture)
+    {
+        return;
+    }
+
     OpenGL::render_begin(fb);
     fb.logic_scissor(scissor);
-    OpenGL::render_texture(button_texture.tex, fb, geometry, {1, 1, 1, 1},
+    OpenGL::render_texture(button_texture->tex, fb, geometry, {1, 1, 1, 1},
         OpenGL::TEXTURE_TRANSFORM_INVERT_Y);
     OpenGL::render_end();
 
@@ -80,24 +87,7 @@ void button_t::render(const wf::render_target_t& fb, wf::geometry_t geometry,
 
 void button_t::update_texture()
 {
-    /**
-     * We render at 100% resolution
-     * When uploading the texture, this gets scaled
-     * to 70% of the titlebar height. Thus we will have
-     * a very crisp image
-     */
-    decoration_theme_t::button_state_t state = {
-        .width  = 1.0 * theme.get_title_height(),
-        .height = 1.0 * theme.get_title_height(),
-        .border = 1.0,
-        .hover_progress = hover,
-    };
-
-    auto surface = theme.get_button_surface(type, state);
-    OpenGL::render_begin();
-    cairo_surface_upload_to_texture(surface, this->button_texture);
-    OpenGL::render_end();
-    cairo_surface_destroy(surface);
+    button_texture = atlas->get_button(theme, type, hover);
 }
 
 void button_t::add_idle_damage()
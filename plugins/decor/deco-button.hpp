@@ -6,6 +6,7 @@
 #include <wayfire/render-manager.hpp>
 #include <wayfire/util/duration.hpp>
 #include <wayfire/plugins/common/simple-texture.hpp>
+#include <wayfire/plugins/common/shared-core-data.hpp>
 
 #include <cairo.h>
 #include <pango/pango.h>
@@ -16,6 +17,7 @@ namespace wf
 namespace decor
 {
 class decoration_theme_t;
+class decoration_atlas_t;
 
 enum button_type_t
 {
@@ -36,7 +38,7 @@ class button_t
     button_t(const decoration_theme_t& theme,
         std::function<void()> damage_callback);
 
-    ~button_t() = default;
+    ~button_t();
     button_t(const button_t &) = delete;
     button_t(button_t &&) = delete;
     button_t& operator =(const button_t&) = delete;
@@ -79,7 +81,9 @@ class button_t
 
     /* Whether the button needs repaint */
     button_type_t type;
-    wf::simple_texture_t button_texture;
+    /* The texture for the current hover state, owned by the atlas */
+    std::shared_ptr<const wf::simple_texture_t> button_texture;
+    wf::shared_data::ref_ptr_t<decoration_atlas_t> atlas;
 
     /* Whether the button is currently being hovered */
     bool is_hovered = false;
@@ -94,7 +98,7 @@ class button_t
     void add_idle_damage();
 
     /**
-     * Redraw the button surface and store it as a texture
+     * Fetch the texture for the current hover state from the atlas
      */
     void update_texture();
 };
@@ -6,6 +6,7 @@
 #include "wayfire/signal-provider.hpp"
 #include "wayfire/toplevel.hpp"
 #include <memory>
+#include <cmath>
 #define GLM_FORCE_RADIANS
 #include <glm/gtc/matrix_transform.hpp>
 
@@ -21,10 +22,9 @@
 #include "deco-subsurface.hpp"
 #include "deco-layout.hpp"
 #include "deco-theme.hpp"
+#include "deco-atlas.hpp"
 #include <wayfire/window-manager.hpp>
 
-#include <wayfire/plugins/common/cairo-util.hpp>
-
 #include <cairo.h>
 
 class simple_decoration_node_t : public wf::scene::node_t, public wf::pointer_interaction_t,
@@ -40,29 +40,37 @@ class simple_decoration_node_t : public wf::scene::node_t, public wf::pointer_in
         }
     };
 
-    void update_title(int width, int height, double scale)
+    /**
+     * The title texture does not depend on the width of the title area, so it only has to be fetched from
+     * the atlas when the title, the font or the height changes, and not on every step of a resize.
+     */
+    void update_title(int height, double scale)
     {
         if (auto view = _view.lock())
         {
-            int target_width  = width * scale;
             int target_height = height * scale;
-            if ((title_texture.tex.width != target_width) || (title_texture.tex.height != target_height) ||
-                (title_texture.current_text != view->get_title()))
+            if (!title_texture.tex || (title_texture.height != target_height) ||
+                (title_texture.current_text != view->get_title()) ||
+                (title_texture.font != theme.get_font()))
             {
-                auto surface = theme.render_text(view->get_title(), target_width, target_height);
-                cairo_surface_upload_to_texture(surface, title_texture.tex);
-                cairo_surface_destroy(surface);
+                title_texture.tex = atlas->get_title(theme, view->get_title(), target_height);
                 title_texture.current_text = view->get_title();
+                title_texture.font   = theme.get_font();
+                title_texture.height = target_height;
             }
         }
     }
 
     struct
     {
-        wf::simple_texture_t tex;
+        wf::decor::decoration_atlas_t::texture_ptr tex;
         std::string current_text = "";
+        std::string font = "";
+        int height = 0;
     } title_texture;
 
+    wf::shared_data::ref_ptr_t<wf::decor::decoration_atlas_t> atlas;
+
   public:
     wf::decor::decoration_theme_t theme;
     wf::decor::decoration_layout_t layout;
@@ -100,11 +108,23 @@ class simple_decoration_node_t : public wf::scene::node_t, public wf::pointer_in
     }
 
     void render_title(const wf::render_target_t& fb,
-        wf::geometry_t geometry)
+        wf::geometry_t geometry, wf::geometry_t scissor)
     {
-        update_title(geometry.width, geometry.height, fb.scale);
-        OpenGL::render_texture(title_texture.tex.tex, fb, geometry,
+        update_title(geometry.height, fb.scale);
+        if (!title_texture.tex || (title_texture.height <= 0))
+        {
+            return;
+        }
+
+        // The texture is as wide as the text, so it is clipped to the title area instead of being stretched
+        wf::geometry_t text_box = geometry;
+        text_box.width = std::ceil(title_texture.tex->width * geometry.height / (double)title_texture.height);
+
+        OpenGL::render_begin(fb);
+        fb.logic_scissor(wf::geometry_intersection(scissor, geometry));
+        OpenGL::render_texture(title_texture.tex->tex, fb, text_box,
             glm::vec4(1.0f), OpenGL::TEXTURE_TRANSFORM_INVERT_Y);
+        OpenGL::render_end();
     }
 
     void render_scissor_box(const wf::render_target_t& fb, wf::point_t origin,
@@ -127,10 +147,7 @@ class simple_decoration_node_t : public wf::scene::node_t, public wf::pointer_in
         {
             if (item->get_type() == wf::decor::DECORATION_AREA_TITLE)
             {
-                OpenGL::render_begin(fb);
-                fb.logic_scissor(scissor);
-                render_title(fb, item->get_geometry() + origin);
-                OpenGL::render_end();
+                render_title(fb, item->get_geometry() + origin, scissor);
             } else // button
             {
                 item->as_button().render(fb,
@@ -3,6 +3,7 @@
 #include <wayfire/opengl.hpp>
 #include <config.h>
 #include <map>
+#include <algorithm>
 
 namespace wf
 {
@@ -24,6 +25,12 @@ int decoration_theme_t::get_border_size() const
     return border_size;
 }
 
+/** @return The font used for the title */
+std::string decoration_theme_t::get_font() const
+{
+    return font;
+}
+
 /** @return The available border for resizing */
 void decoration_theme_t::set_buttons(button_type_t flags)
 {
@@ -49,35 +56,46 @@ void decoration_theme_t::render_background(const wf::render_target_t& fb,
 }
 
 /**
- * Render the given text on a cairo_surface_t with the given size.
+ * Render the given text on a cairo_surface_t with the given height.
  * The caller is responsible for freeing the memory afterwards.
  */
-cairo_surface_t*decoration_theme_t::render_text(std::string text,
-    int width, int height) const
+cairo_surface_t*decoration_theme_t::render_text(std::string text, int height) const
 {
     const auto format = CAIRO_FORMAT_ARGB32;
-    auto surface = cairo_image_surface_create(format, width, height);
+    // Longer titles do not fit on any screen anyway, and GL textures have a maximal size.
+    const int max_width = 4096;
 
-    if (height == 0)
+    if ((height <= 0) || text.empty())
     {
-        return surface;
+        return cairo_image_surface_create(format, 1, std::max(height, 1));
     }
 
-    auto cr = cairo_create(surface);
-
     const float font_scale = 0.8;
     const float font_size  = height * font_scale;
 
     PangoFontDescription *font_desc;
     PangoLayout *layout;
 
-    // render text
     font_desc = pango_font_description_from_string(((std::string)font).c_str());
     pango_font_description_set_absolute_size(font_desc, font_size * PANGO_SCALE);
 
+    // measure text on a dummy surface first
+    auto measure_surface = cairo_image_surface_create(format, 1, 1);
+    auto cr = cairo_create(measure_surface);
     layout = pango_cairo_create_layout(cr);
     pango_layout_set_font_description(layout, font_desc);
     pango_layout_set_text(layout, text.c_str(), text.size());
+
+    int width;
+    pango_layout_get_pixel_size(layout, &width, nullptr);
+    width = std::clamp(width, 1, max_width);
+    cairo_destroy(cr);
+    cairo_surface_destroy(measure_surface);
+
+    // render text
+    auto surface = cairo_image_surface_create(format, width, height);
+    cr = cairo_create(surface);
+    pango_cairo_update_layout(cr, layout);
     cairo_set_source_rgba(cr, 1, 1, 1, 1);
     pango_cairo_show_layout(cr, layout);
     pango_font_description_free(font_desc);
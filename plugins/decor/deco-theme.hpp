@@ -20,6 +20,8 @@ class decoration_theme_t
     int get_title_height() const;
     /** @return The available border for resizing */
     int get_border_size() const;
+    /** @return The font used for the title */
+    std::string get_font() const;
     /** Set the flags for buttons */
     void set_buttons(button_type_t flags);
     button_type_t button_flags;
@@ -36,10 +38,12 @@ class decoration_theme_t
         const wf::geometry_t& scissor, bool active) const;
 
     /**
-     * Render the given text on a cairo_surface_t with the given size.
+     * Render the given text on a cairo_surface_t with the given height.
+     * The surface is as wide as the text (up to an upper limit), so it does not depend on the size of the
+     * title area.
      * The caller is responsible for freeing the memory afterwards.
      */
-    cairo_surface_t *render_text(std::string text, int width, int height) const;
+    cairo_surface_t *render_text(std::string text, int height) const;
 
     struct button_state_t
     {
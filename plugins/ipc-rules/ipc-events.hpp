@@ -2,6 +2,7 @@
 
 #include "ipc-rules-common.hpp"
 #include <set>
+#include <wayfire/util.hpp>
 #include "plugins/ipc/ipc-method-repository.hpp"
 #include "wayfire/seat.hpp"
 #include <wayfire/per-output-plugin.hpp>
@@ -125,18 +126,43 @@ class ipc_rules_events_methods_t : public wf::per_output_tracker_mixin_t<>
         {"wset-workspace-changed", get_generic_output_registration_cb(&on_wset_workspace_changed)},
     };
 
+    struct coalesced_event_t
+    {
+        std::string event_name;
+        int64_t view_id;
+        wf::json_t data;
+    };
+
+    struct watcher_t
+    {
+        std::set<std::string> events;
+
+        // If non-zero, events about a view are sent at most once every coalesce_ms milliseconds, and only
+        // the latest event of each type for each view is sent.
+        int coalesce_ms = 0;
+        // Coalesced events waiting to be sent, in the order in which they should be sent.
+        std::vector<coalesced_event_t> pending;
+        std::unique_ptr<wf::wl_timer<false>> timer;
+    };
+
     // Track a list of clients which have requested watch
-    std::map<wf::ipc::client_interface_t*, std::set<std::string>> clients;
+    std::map<wf::ipc::client_interface_t*, watcher_t> clients;
 
     wf::ipc::method_callback_full on_client_watch =
         [=] (wf::json_t data, wf::ipc::client_interface_t *client)
     {
         static constexpr const char *EVENTS = "events";
+        static constexpr const char *COALESCE_MS = "coalesce-ms";
         if (data.has_member(EVENTS) && !data[EVENTS].is_array())
         {
             return wf::ipc::json_error("Event list is not an array!");
         }
 
+        if (data.has_member(COALESCE_MS) && (!data[COALESCE_MS].is_int() || ((int)data[COALESCE_MS] < 0)))
+        {
+            return wf::ipc::json_error("coalesce-ms must be a non-negative integer!");
+        }
+
         std::set<std::string> subscribed_to;
         if (data.has_member(EVENTS))
         {
@@ -166,14 +192,17 @@ class ipc_rules_events_methods_t : public wf::per_output_tracker_mixin_t<>
             signal_map[ev_name].increase_count();
         }
 
-        clients[client] = subscribed_to;
+        auto& watcher = clients[client];
+        watcher.events = subscribed_to;
+        watcher.coalesce_ms = data.has_member(COALESCE_MS) ? (int)data[COALESCE_MS] : 0;
+        watcher.timer = std::make_unique<wf::wl_timer<false>>();
         return wf::ipc::json_ok();
     };
 
     wf::signal::connection_t<wf::ipc::client_disconnected_signal> on_client_disconnected =
         [=] (wf::ipc::client_disconnected_signal *ev)
     {
-        for (auto& ev_name : clients[ev->client])
+        for (auto& ev_name : clients[ev->client].events)
         {
             signal_map[ev_name].decrease_count();
         }
@@ -191,12 +220,74 @@ class ipc_rules_events_methods_t : public wf::per_output_tracker_mixin_t<>
 
     void send_event_to_subscribes(const wf::json_t& data, const std::string& event_name)
     {
-        for (auto& [client, events] : clients)
+        const bool has_view = data.has_member("view") && data["view"].is_object() &&
+            data["view"].has_member("id") && data["view"]["id"].is_int64();
+
+        // Serialize the event once and share the buffer between all clients, and only if someone wants it.
+        wf::ipc::serialized_message_t message;
+        for (auto& [client, watcher] : clients)
         {
-            if (events.empty() || events.count(event_name))
+            if (!watcher.events.empty() && !watcher.events.count(event_name))
             {
-                client->send_json(data);
+                continue;
             }
+
+            if (watcher.coalesce_ms && has_view)
+            {
+                coalesce_event(client, watcher, data, event_name);
+                continue;
+            }
+
+            // Events which are being coalesced happened before this one, keep the order of the events.
+            send_coalesced_events(client, watcher);
+            if (!message)
+            {
+                message = wf::ipc::serialize_message(data);
+            }
+
+            client->send_serialized(message);
+        }
+    }
+
+    void coalesce_event(wf::ipc::client_interface_t *client, watcher_t& watcher, const wf::json_t& data,
+        const std::string& event_name)
+    {
+        coalesced_event_t event{event_name, data["view"]["id"].as_int64(), data};
+        auto it = std::find_if(watcher.pending.begin(), watcher.pending.end(), [&] (const auto& pending)
+        {
+            return (pending.event_name == event.event_name) && (pending.view_id == event.view_id);
+        });
+
+        if (it != watcher.pending.end())
+        {
+            // The client sees a single change from the state it knows about to the latest state.
+            if (it->data.has_member("old-geometry"))
+            {
+                event.data["old-geometry"] = it->data["old-geometry"];
+            }
+
+            // The latest event is sent after other events which have happened before it.
+            watcher.pending.erase(it);
+        }
+
+        watcher.pending.push_back(std::move(event));
+        if (!watcher.timer->is_connected())
+        {
+            watcher.timer->set_timeout(watcher.coalesce_ms, [this, client, &watcher] ()
+            {
+                send_coalesced_events(client, watcher);
+            });
+        }
+    }
+
+    void send_coalesced_events(wf::ipc::client_interface_t *client, watcher_t& watcher)
+    {
+        watcher.timer->disconnect();
+        auto pending = std::move(watcher.pending);
+        watcher.pending.clear();
+        for (auto& event : pending)
+        {
+            client->send_json(std::move(event.data));
         }
     }
 
@@ -15,11 +15,13 @@
 #include "ipc-input-methods.hpp"
 #include "ipc-utility-methods.hpp"
 #include "ipc-events.hpp"
+#include "ipc-snapshot-methods.hpp"
 
 class ipc_rules_t : public wf::plugin_interface_t,
     public wf::ipc_rules_input_methods_t,
     public wf::ipc_rules_utility_methods_t,
-    public wf::ipc_rules_events_methods_t
+    public wf::ipc_rules_events_methods_t,
+    public wf::ipc_rules_snapshot_methods_t
 {
   public:
     void init() override
@@ -40,6 +42,7 @@ class ipc_rules_t : public wf::plugin_interface_t,
         init_input_methods(method_repository.get());
         init_utility_methods(method_repository.get());
         init_events(method_repository.get());
+        init_snapshot_methods(method_repository.get());
     }
 
     void fini() override
@@ -60,6 +63,7 @@ class ipc_rules_t : public wf::plugin_interface_t,
         fini_input_methods(method_repository.get());
         fini_utility_methods(method_repository.get());
         fini_events(method_repository.get());
+        fini_snapshot_methods(method_repository.get());
     }
 
     wf::ipc::method_callback list_views = [=] (wf::json_t)
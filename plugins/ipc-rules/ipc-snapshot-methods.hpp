@@ -0,0 +1,437 @@
+#pragma once
+#include "ipc-rules-common.hpp"
+#include "plugins/ipc/ipc-method-repository.hpp"
+#include <cstdio>
+#include <map>
+#include <optional>
+#include <random>
+#include <set>
+#include <unordered_map>
+#include <wayfire/output-layout.hpp>
+#include <wayfire/seat.hpp>
+#include <wayfire/signal-definitions.hpp>
+#include <wayfire/toplevel-view.hpp>
+
+namespace wf
+{
+/**
+ * Tracks the sequence number of the last change of each view, output and workspace set, so that clients can
+ * ask only for the objects which changed since they last asked.
+ *
+ * Views are tracked with signals, as there may be many of them. The few properties of views which change
+ * without a signal, as well as outputs and workspace sets, are compared with their last known state whenever
+ * a client asks for changes.
+ */
+class ipc_rules_snapshot_methods_t
+{
+  public:
+    void init_snapshot_methods(ipc::method_repository_t *method_repository)
+    {
+        method_repository->register_method("window-rules/list-changes", list_changes);
+    }
+
+    void fini_snapshot_methods(ipc::method_repository_t *method_repository)
+    {
+        method_repository->unregister_method("window-rules/list-changes");
+        stop_tracking();
+    }
+
+  private:
+    enum object_kind_t
+    {
+        OBJECT_VIEW   = 0,
+        OBJECT_OUTPUT = 1,
+        OBJECT_WSET   = 2,
+    };
+
+    using object_key_t = std::pair<object_kind_t, uint64_t>;
+
+    struct object_state_t
+    {
+        uint64_t sequence;
+        bool removed;
+    };
+
+    // The maximal number of removed objects to remember. Clients asking for changes older than the oldest
+    // forgotten removal get a full snapshot instead.
+    static constexpr size_t MAX_REMOVED = 1024;
+
+    bool tracking = false;
+    // A random token which identifies this tracking session. Sequence numbers start again from 0 after the
+    // plugin is reloaded or the compositor is restarted, so they are meaningful only together with the epoch.
+    std::string epoch;
+    uint64_t sequence = 0;
+    uint64_t oldest_valid = 0;
+    std::map<object_key_t, object_state_t> objects;
+    std::map<uint64_t, object_key_t> changed;
+    std::map<uint64_t, object_key_t> removed;
+
+    // The properties of a view which are reported, but which can change without a signal.
+    struct polled_view_state_t
+    {
+        std::optional<wf::scene::layer> layer;
+        wf::geometry_t bbox;
+        wf::dimensions_t min_size;
+        wf::dimensions_t max_size;
+        bool focusable;
+
+        polled_view_state_t(wayfire_view view)
+        {
+            auto toplevel = wf::toplevel_cast(view);
+            layer     = get_view_layer(view);
+            bbox      = view->get_bounding_box();
+            min_size  = toplevel ? toplevel->toplevel()->get_min_size() : wf::dimensions_t{0, 0};
+            max_size  = toplevel ? toplevel->toplevel()->get_max_size() : wf::dimensions_t{0, 0};
+            focusable = view->is_focusable();
+        }
+
+        bool operator ==(const polled_view_state_t& other) const
+        {
+            return (layer == other.layer) && (bbox == other.bbox) && (min_size == other.min_size) &&
+                   (max_size == other.max_size) && (focusable == other.focusable);
+        }
+    };
+
+    struct tracked_view_t
+    {
+        wayfire_view view;
+        polled_view_state_t polled;
+    };
+
+    std::unordered_map<uint64_t, tracked_view_t> views;
+    wayfire_view last_focus = nullptr;
+    // The last reported state of outputs and workspace sets
+    std::map<object_key_t, std::string> known_state;
+
+    void mark(object_kind_t kind, uint64_t id, bool is_removed)
+    {
+        object_key_t key{kind, id};
+        auto it = objects.find(key);
+        if (it != objects.end())
+        {
+            (it->second.removed ? removed : changed).erase(it->second.sequence);
+        }
+
+        ++sequence;
+        objects[key] = {sequence, is_removed};
+        (is_removed ? removed : changed)[sequence] = key;
+
+        while (removed.size() > MAX_REMOVED)
+        {
+            oldest_valid = removed.begin()->first;
+            objects.erase(removed.begin()->second);
+            removed.erase(removed.begin());
+        }
+    }
+
+    void view_changed(wayfire_view view)
+    {
+        if (view && views.count(view->get_id()))
+        {
+            mark(OBJECT_VIEW, view->get_id(), false);
+        }
+    }
+
+    void track_view(wayfire_view view)
+    {
+        if (!views.count(view->get_id()))
+        {
+            views.emplace(view->get_id(), tracked_view_t{view, polled_view_state_t{view}});
+            // Signals which are emitted only on the view
+            view->connect(&on_view_parent_changed);
+            view->connect(&on_view_activated);
+        }
+
+        mark(OBJECT_VIEW, view->get_id(), false);
+    }
+
+    void untrack_view(wayfire_view view)
+    {
+        if (views.erase(view->get_id()))
+        {
+            view->disconnect(&on_view_parent_changed);
+            view->disconnect(&on_view_activated);
+            mark(OBJECT_VIEW, view->get_id(), true);
+        }
+    }
+
+    static std::string generate_epoch()
+    {
+        std::random_device rd;
+        const uint64_t value = ((uint64_t)rd() << 32) | rd();
+
+        char buffer[17];
+        snprintf(buffer, sizeof(buffer), "%016llx", (unsigned long long)value);
+        return buffer;
+    }
+
+    void start_tracking()
+    {
+        tracking = true;
+        epoch    = generate_epoch();
+        for (auto& view : wf::get_core().get_all_views())
+        {
+            if (view->is_mapped())
+            {
+                track_view(view);
+            }
+        }
+
+        last_focus = wf::get_core().seat->get_active_view();
+        wf::get_core().connect(&on_view_mapped);
+        wf::get_core().connect(&on_view_unmapped);
+        wf::get_core().connect(&on_view_geometry_changed);
+        wf::get_core().connect(&on_view_title_changed);
+        wf::get_core().connect(&on_view_app_id_changed);
+        wf::get_core().connect(&on_view_set_output);
+        wf::get_core().connect(&on_view_moved_to_wset);
+        wf::get_core().connect(&on_view_tiled);
+        wf::get_core().connect(&on_view_fullscreen);
+        wf::get_core().connect(&on_kbfocus_changed);
+
+        wf::get_core().output_layout->connect(&on_output_added);
+        for (auto& output : wf::get_core().output_layout->get_outputs())
+        {
+            connect_output(output);
+        }
+    }
+
+    void stop_tracking()
+    {
+        tracking = false;
+        on_view_mapped.disconnect();
+        on_view_unmapped.disconnect();
+        on_view_geometry_changed.disconnect();
+        on_view_title_changed.disconnect();
+        on_view_app_id_changed.disconnect();
+        on_view_set_output.disconnect();
+        on_view_moved_to_wset.disconnect();
+        on_view_tiled.disconnect();
+        on_view_fullscreen.disconnect();
+        on_kbfocus_changed.disconnect();
+        on_output_added.disconnect();
+        on_view_minimized.disconnect();
+        on_view_sticky.disconnect();
+        on_view_workspace_changed.disconnect();
+        on_view_parent_changed.disconnect();
+        on_view_activated.disconnect();
+        views.clear();
+        last_focus = nullptr;
+
+        // A later session starts with a new epoch, and must not report the state of this one.
+        sequence     = 0;
+        oldest_valid = 0;
+        objects.clear();
+        changed.clear();
+        removed.clear();
+        known_state.clear();
+    }
+
+    void connect_output(wf::output_t *output)
+    {
+        // Signals which are emitted only on the view's output
+        output->connect(&on_view_minimized);
+        output->connect(&on_view_sticky);
+        output->connect(&on_view_workspace_changed);
+    }
+
+    // Compare the properties of views which change without a signal with their last reported state.
+    void refresh_views()
+    {
+        for (auto& [id, tracked] : views)
+        {
+            polled_view_state_t state{tracked.view};
+            if (!(state == tracked.polled))
+            {
+                tracked.polled = state;
+                mark(OBJECT_VIEW, id, false);
+            }
+        }
+    }
+
+    // Compare the current state of outputs and workspace sets with the last reported state.
+    void refresh_outputs_and_wsets()
+    {
+        std::set<object_key_t> alive;
+        auto update = [&] (object_kind_t kind, uint64_t id, const wf::json_t& state)
+        {
+            object_key_t key{kind, id};
+            alive.insert(key);
+
+            auto serialized = state.serialize();
+            auto it = known_state.find(key);
+            if ((it == known_state.end()) || (it->second != serialized))
+            {
+                known_state[key] = std::move(serialized);
+                mark(kind, id, false);
+            }
+        };
+
+        for (auto& output : wf::get_core().output_layout->get_outputs())
+        {
+            update(OBJECT_OUTPUT, output->get_id(), output_to_json(output));
+        }
+
+        for (auto& wset : wf::workspace_set_t::get_all())
+        {
+            update(OBJECT_WSET, wset->get_index(), wset_to_json(wset.get()));
+        }
+
+        for (auto it = known_state.begin(); it != known_state.end();)
+        {
+            if (alive.count(it->first))
+            {
+                ++it;
+            } else
+            {
+                mark(it->first.first, it->first.second, true);
+                it = known_state.erase(it);
+            }
+        }
+    }
+
+    wf::json_t object_to_json(const object_key_t& key)
+    {
+        switch (key.first)
+        {
+          case OBJECT_VIEW:
+            return view_to_json(views.at(key.second).view);
+
+          case OBJECT_OUTPUT:
+            return output_to_json(wf::ipc::find_output_by_id(key.second));
+
+          case OBJECT_WSET:
+            return wset_to_json(wf::ipc::find_workspace_set_by_index(key.second));
+        }
+
+        return wf::json_t::null();
+    }
+
+    /**
+     * Get the views, outputs and workspace sets which changed or were removed after the sequence number
+     * "since". The response contains the current sequence number and epoch, which should be passed as
+     * "since" and "epoch" the next time. If "since" is 0 or too old, or the epoch does not match, all objects
+     * are listed and "reset" is set to true.
+     */
+    wf::ipc::method_callback list_changes = [=] (wf::json_t data)
+    {
+        if (data.has_member("since") && !data["since"].is_uint64())
+        {
+            return wf::ipc::json_error("since must be a non-negative integer!");
+        }
+
+        if (data.has_member("epoch") && !data["epoch"].is_string())
+        {
+            return wf::ipc::json_error("epoch must be a string!");
+        }
+
+        if (!tracking)
+        {
+            start_tracking();
+        }
+
+        refresh_views();
+        refresh_outputs_and_wsets();
+
+        static const char *changed_names[] = {"views", "outputs", "wsets"};
+        static const char *removed_names[] = {"removed-views", "removed-outputs", "removed-wsets"};
+
+        uint64_t since = data.has_member("since") ? data["since"].as_uint64() : 0;
+        const bool same_epoch = data.has_member("epoch") && (data["epoch"].as_string() == epoch);
+        const bool reset = !same_epoch || (since == 0) || (since < oldest_valid) || (since > sequence);
+        if (reset)
+        {
+            since = 0;
+        }
+
+        wf::json_t response;
+        response["sequence"] = sequence;
+        response["epoch"]    = epoch;
+        response["reset"]    = reset;
+        for (int i = 0; i < 3; i++)
+        {
+            response[changed_names[i]] = wf::json_t::array();
+            response[removed_names[i]] = wf::json_t::array();
+        }
+
+        for (auto it = changed.upper_bound(since); it != changed.end(); ++it)
+        {
+            response[changed_names[it->second.first]].append(object_to_json(it->second));
+        }
+
+        if (!reset)
+        {
+            for (auto it = removed.upper_bound(since); it != removed.end(); ++it)
+            {
+                response[removed_names[it->second.first]].append(it->second.second);
+            }
+        }
+
+        return response;
+    };
+
+    wf::signal::connection_t<wf::output_added_signal> on_output_added = [=] (wf::output_added_signal *ev)
+    {
+        connect_output(ev->output);
+    };
+
+    wf::signal::connection_t<wf::view_mapped_signal> on_view_mapped = [=] (wf::view_mapped_signal *ev)
+    {
+        track_view(ev->view);
+    };
+
+    wf::signal::connection_t<wf::view_unmapped_signal> on_view_unmapped = [=] (wf::view_unmapped_signal *ev)
+    {
+        untrack_view(ev->view);
+        if (last_focus == ev->view)
+        {
+            last_focus = nullptr;
+        }
+    };
+
+    wf::signal::connection_t<wf::view_geometry_changed_signal> on_view_geometry_changed =
+        [=] (wf::view_geometry_changed_signal *ev) { view_changed(ev->view); };
+
+    wf::signal::connection_t<wf::view_title_changed_signal> on_view_title_changed =
+        [=] (wf::view_title_changed_signal *ev) { view_changed(ev->view); };
+
+    wf::signal::connection_t<wf::view_app_id_changed_signal> on_view_app_id_changed =
+        [=] (wf::view_app_id_changed_signal *ev) { view_changed(ev->view); };
+
+    wf::signal::connection_t<wf::view_set_output_signal> on_view_set_output =
+        [=] (wf::view_set_output_signal *ev) { view_changed(ev->view); };
+
+    wf::signal::connection_t<wf::view_moved_to_wset_signal> on_view_moved_to_wset =
+        [=] (wf::view_moved_to_wset_signal *ev) { view_changed(ev->view); };
+
+    wf::signal::connection_t<wf::view_tiled_signal> on_view_tiled =
+        [=] (wf::view_tiled_signal *ev) { view_changed(ev->view); };
+
+    wf::signal::connection_t<wf::view_fullscreen_signal> on_view_fullscreen =
+        [=] (wf::view_fullscreen_signal *ev) { view_changed(ev->view); };
+
+    wf::signal::connection_t<wf::view_minimized_signal> on_view_minimized =
+        [=] (wf::view_minimized_signal *ev) { view_changed(ev->view); };
+
+    wf::signal::connection_t<wf::view_set_sticky_signal> on_view_sticky =
+        [=] (wf::view_set_sticky_signal *ev) { view_changed(ev->view); };
+
+    wf::signal::connection_t<wf::view_change_workspace_signal> on_view_workspace_changed =
+        [=] (wf::view_change_workspace_signal *ev) { view_changed(ev->view); };
+
+    wf::signal::connection_t<wf::view_parent_changed_signal> on_view_parent_changed =
+        [=] (wf::view_parent_changed_signal *ev) { view_changed(ev->view); };
+
+    wf::signal::connection_t<wf::view_activated_state_signal> on_view_activated =
+        [=] (wf::view_activated_state_signal *ev) { view_changed(ev->view); };
+
+    wf::signal::connection_t<wf::keyboard_focus_changed_signal> on_kbfocus_changed =
+        [=] (wf::keyboard_focus_changed_signal *ev)
+    {
+        // Both the activated state and the focus timestamp of the views change
+        view_changed(last_focus);
+        last_focus = wf::node_to_view(ev->new_focus);
+        view_changed(last_focus);
+    };
+};
+}
@@ -7,6 +7,10 @@
 #include <wayfire/plugin.hpp>
 #include <wayfire/nonstd/wlroots-full.hpp>
 #include <wayfire/output-layout.hpp>
+#include <wayfire/render-manager.hpp>
+#include <wayfire/scene-render.hpp>
+#include <wayfire/matcher.hpp>
+#include <wayfire/opengl.hpp>
 #include <wayfire/config/compound-option.hpp>
 #include <wayfire/config/config-manager.hpp>
 
@@ -31,6 +35,7 @@ class ipc_rules_utility_methods_t
         method_repository->register_method("wayfire/destroy-headless-output", destroy_headless_output);
         method_repository->register_method("wayfire/get-config-option", get_config_option);
         method_repository->register_method("wayfire/set-config-options", set_config_options);
+        method_repository->register_method("wayfire/frame-stats", get_frame_stats);
     }
 
     void fini_utility_methods(ipc::method_repository_t *method_repository)
@@ -40,6 +45,7 @@ class ipc_rules_utility_methods_t
         method_repository->unregister_method("wayfire/destroy-headless-output");
         method_repository->unregister_method("wayfire/get-config-option");
         method_repository->unregister_method("wayfire/set-config-option");
+        method_repository->unregister_method("wayfire/frame-stats");
     }
 
     wf::ipc::method_callback get_wayfire_configuration_info = [=] (wf::json_t)
@@ -112,6 +118,82 @@ class ipc_rules_utility_methods_t
         return wf::ipc::json_ok();
     };
 
+    static wf::json_t frame_stats_to_json(wf::output_t *wo, size_t max_frames)
+    {
+        static const char *phase_names[wf::FRAME_PHASE_TOTAL] = {
+            "effects", "scanout", "render", "overlay", "postprocess", "swap"
+        };
+
+        auto stats = wo->render->get_frame_stats();
+        wf::json_t response;
+        response["output-id"]  = wo->get_id();
+        response["output"]     = wo->to_string();
+        response["painted"]    = stats.painted;
+        response["skipped"]    = stats.skipped;
+        response["scanout"]    = stats.scanout;
+        response["gpu-timers"] = stats.gpu_timers;
+
+        response["frames"] = wf::json_t::array();
+        const size_t first = stats.frames.size() - std::min(stats.frames.size(), max_frames);
+        for (size_t i = first; i < stats.frames.size(); i++)
+        {
+            const auto& frame = stats.frames[i];
+            wf::json_t f;
+            f["start"]   = frame.start;
+            f["scanout"] = frame.scanout;
+            f["gpu"]     = frame.gpu_ns;
+            f["damage-rects"] = frame.damage_rects;
+            f["damage-rects-merged"] = frame.damage_rects_merged;
+            for (int phase = 0; phase < wf::FRAME_PHASE_TOTAL; phase++)
+            {
+                f[phase_names[phase]] = frame.cpu_ns[phase];
+            }
+
+            response["frames"].append(f);
+        }
+
+        return response;
+    }
+
+    wf::ipc::method_callback get_frame_stats = [=] (const wf::json_t& data)
+    {
+        auto output_id  = wf::ipc::json_get_optional_uint64(data, "output-id");
+        auto max_frames = wf::ipc::json_get_optional_uint64(data, "frames").value_or(-1);
+
+        auto response = wf::ipc::json_ok();
+        response["instruction-allocations"] = wf::scene::get_render_pass_allocations();
+
+        auto matcher_stats = wf::get_view_matcher_cache_stats();
+        response["matcher-cache"]["hits"]   = matcher_stats.hits;
+        response["matcher-cache"]["misses"] = matcher_stats.misses;
+
+        auto pool_stats = OpenGL::get_framebuffer_pool_stats();
+        response["framebuffer-pool"]["used-buffers"] = pool_stats.used_buffers;
+        response["framebuffer-pool"]["free-buffers"] = pool_stats.free_buffers;
+        response["framebuffer-pool"]["total-bytes"]  = pool_stats.total_bytes;
+        response["framebuffer-pool"]["hits"]   = pool_stats.hits;
+        response["framebuffer-pool"]["misses"] = pool_stats.misses;
+        response["outputs"] = wf::json_t::array();
+        if (output_id.has_value())
+        {
+            auto wo = wf::ipc::find_output_by_id(output_id.value());
+            if (!wo)
+            {
+                return wf::ipc::json_error("Output not found!");
+            }
+
+            response["outputs"].append(frame_stats_to_json(wo, max_frames));
+        } else
+        {
+            for (auto& wo : wf::get_core().output_layout->get_outputs())
+            {
+                response["outputs"].append(frame_stats_to_json(wo, max_frames));
+            }
+        }
+
+        return response;
+    };
+
     wf::ipc::method_callback get_config_option = [=] (const wf::json_t& data)
     {
         auto option_name = wf::ipc::json_get_string(data, "option");
@@ -250,6 +332,7 @@ class ipc_rules_utility_methods_t
             return wf::ipc::json_error("Options must be an object!");
         }
 
+        reload_config_signal event;
         for (auto& option : data.get_member_names())
         {
             auto opt = wf::get_core().config->get_option(option);
@@ -275,9 +358,9 @@ class ipc_rules_utility_methods_t
             }
 
             opt->set_locked(true);
+            event.changed.push_back(option);
         }
 
-        reload_config_signal event;
         wf::get_core().emit(&event);
         return wf::ipc::json_ok();
     };
@@ -2,6 +2,7 @@
 
 #include <functional>
 #include <map>
+#include <memory>
 #include "wayfire/signal-provider.hpp"
 #include <wayfire/nonstd/json.hpp>
 #include <string>
@@ -22,6 +23,17 @@ class ipc_method_exception_t : public std::exception
     }
 };
 
+/**
+ * A serialized IPC message. The buffer is shared by all clients the message is sent to, so that messages
+ * for many clients (e.g. events) are serialized only once.
+ */
+using serialized_message_t = std::shared_ptr<const std::string>;
+
+inline serialized_message_t serialize_message(const json_t& json)
+{
+    return std::make_shared<const std::string>(json.serialize());
+}
+
 /**
  * A client_interface_t represents a client which has connected to the IPC socket.
  * It can be used by plugins to send back data to a specific client.
@@ -30,6 +42,24 @@ class client_interface_t
 {
   public:
     virtual bool send_json(json_t json) = 0;
+
+    /**
+     * Send a message which was already serialized with serialize_message().
+     *
+     * The default implementation parses the message again and forwards it to send_json(), so that existing
+     * implementations keep working. Implementations should override it to avoid the extra work.
+     */
+    virtual bool send_serialized(const serialized_message_t& message)
+    {
+        json_t json;
+        if (json_t::parse_string(*message, json).has_value())
+        {
+            return false;
+        }
+
+        return send_json(std::move(json));
+    }
+
     virtual ~client_interface_t() = default;
 };
 
@@ -129,6 +159,46 @@ class method_repository_t : public wf::signal::provider_t
 
             return response;
         });
+
+        // Call multiple methods in one request, to avoid a round trip for each call. The parameters are
+        // {"calls": [{"method": ..., "data": ...}, ...]}, and the results of the individual calls are
+        // returned in the same order in the "results" array.
+        register_method("batch", [this] (const wf::json_t& data, client_interface_t *client)
+        {
+            wf::json_t response;
+            if (!data.has_member("calls") || !data["calls"].is_array())
+            {
+                response["error"] = "Missing \"calls\" array!";
+                return response;
+            }
+
+            response["results"] = wf::json_t::array();
+            for (size_t i = 0; i < data["calls"].size(); i++)
+            {
+                wf::json_t call = data["calls"][i];
+                if (!call.is_object() || !call.has_member("method") || !call["method"].is_string())
+                {
+                    wf::json_t error;
+                    error["error"] = "Batched call does not contain a method to be called!";
+                    response["results"].append(error);
+                    continue;
+                }
+
+                const std::string method = call["method"];
+                if (method == "batch")
+                {
+                    wf::json_t error;
+                    error["error"] = "Batch calls cannot be nested!";
+                    response["results"].append(error);
+                    continue;
+                }
+
+                wf::json_t params = call.has_member("data") ? wf::json_t(call["data"]) : wf::json_t();
+                response["results"].append(call_method(method, std::move(params), client));
+            }
+
+            return response;
+        });
     }
 
   private:
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <cerrno>
+#include <cstdint>
+#include <deque>
+#include <sys/socket.h>
+#include "ipc-method-repository.hpp"
+
+namespace wf
+{
+namespace ipc
+{
+/**
+ * Messages which are to be sent to an IPC client over a non-blocking socket.
+ *
+ * Each message is framed with its length (4 bytes, host byte order), as expected by the IPC protocol.
+ * Anything which cannot be written to the socket immediately stays queued until the next flush().
+ * The queue only keeps references to the serialized messages, so the same message can be queued for many
+ * clients without copying it.
+ */
+class output_queue_t
+{
+  public:
+    static constexpr size_t HEADER_LEN = 4;
+
+    enum class push_result_t
+    {
+        /** The message was queued. */
+        QUEUED,
+        /** The queue is over the high-water mark, and the message was dropped. */
+        DROPPED,
+        /** The queue is over the high-water mark, and the message could not be dropped. */
+        OVERFLOW,
+    };
+
+    /**
+     * The maximal number of bytes which may be waiting to be written before new messages are rejected.
+     * 0 means that there is no limit.
+     */
+    size_t high_water_mark = 0;
+
+    /** The number of messages dropped because the queue was over the high-water mark. */
+    uint64_t dropped = 0;
+
+    /**
+     * Add a message to the queue.
+     *
+     * @param droppable Whether the message may be dropped if the client is too slow to read its messages.
+     */
+    push_result_t push(serialized_message_t message, bool droppable)
+    {
+        if (high_water_mark && (pending() > high_water_mark))
+        {
+            if (droppable)
+            {
+                ++dropped;
+                return push_result_t::DROPPED;
+            }
+
+            return push_result_t::OVERFLOW;
+        }
+
+        pending_bytes += HEADER_LEN + message->size();
+        messages.push_back({(uint32_t)message->size(), std::move(message)});
+        return push_result_t::QUEUED;
+    }
+
+    /**
+     * Write as much of the queue as possible to the given non-blocking socket.
+     *
+     * @return false if the socket is no longer usable.
+     */
+    bool flush(int fd)
+    {
+        static constexpr size_t MAX_IOVECS = 64;
+        iovec iov[MAX_IOVECS];
+
+        while (!messages.empty())
+        {
+            // Gather the header and the contents of as many messages as possible, skipping the part of the
+            // first message which was already written.
+            size_t nr_iov = 0;
+            size_t skip   = written;
+            for (auto it = messages.begin(); (it != messages.end()) && (nr_iov + 2 <= MAX_IOVECS); ++it)
+            {
+                const char *parts[2] = {(const char*)&it->header, it->data->data()};
+                const size_t sizes[2] = {HEADER_LEN, it->data->size()};
+                for (int i = 0; i < 2; i++)
+                {
+                    if (skip >= sizes[i])
+                    {
+                        skip -= sizes[i];
+                        continue;
+                    }
+
+                    iov[nr_iov].iov_base = (void*)(parts[i] + skip);
+                    iov[nr_iov].iov_len  = sizes[i] - skip;
+                    skip = 0;
+                    ++nr_iov;
+                }
+            }
+
+            msghdr msg{};
+            msg.msg_iov    = iov;
+            msg.msg_iovlen = nr_iov;
+            ssize_t w = sendmsg(fd, &msg, MSG_NOSIGNAL);
+            if ((w < 0) && (errno == EINTR))
+            {
+                continue;
+            }
+
+            if ((w < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK)))
+            {
+                break;
+            }
+
+            if (w <= 0)
+            {
+                clear();
+                return false;
+            }
+
+            consume(w);
+        }
+
+        return true;
+    }
+
+    /** The number of bytes waiting to be written. */
+    size_t pending() const
+    {
+        return pending_bytes;
+    }
+
+    bool empty() const
+    {
+        return messages.empty();
+    }
+
+    void clear()
+    {
+        messages.clear();
+        written = 0;
+        pending_bytes = 0;
+    }
+
+  private:
+    struct message_t
+    {
+        uint32_t header;
+        serialized_message_t data;
+    };
+
+    std::deque<message_t> messages;
+    /** The number of bytes of the first message which were already written. */
+    size_t written = 0;
+    size_t pending_bytes = 0;
+
+    void consume(size_t bytes)
+    {
+        pending_bytes -= bytes;
+        written += bytes;
+        while (!messages.empty() && (written >= HEADER_LEN + messages.front().data->size()))
+        {
+            written -= HEADER_LEN + messages.front().data->size();
+            messages.pop_front();
+        }
+    }
+};
+}
+}
@@ -10,6 +10,7 @@
 #include <sys/ioctl.h>
 #include <unistd.h>
 #include <cstring>
+#include <cerrno>
 
 /**
  * Handle WL_EVENT_READABLE on the socket.
@@ -134,7 +135,8 @@ void wf::ipc::server_t::client_disappeared(client_t *client)
 void wf::ipc::server_t::handle_incoming_message(
     client_t *client, wf::json_t message)
 {
-    client->send_json(method_repository->call_method(message["method"], message["data"], client));
+    auto response = method_repository->call_method(message["method"], message["data"], client);
+    client->queue_message(serialize_message(response), false);
 }
 
 /* --------------------------- Per-client code ------------------------------*/
@@ -205,6 +207,16 @@ void wf::ipc::client_t::handle_fd_incoming(uint32_t event_mask)
         return;
     }
 
+    if (event_mask & WL_EVENT_WRITABLE)
+    {
+        flush_output();
+    }
+
+    if (!(event_mask & WL_EVENT_READABLE))
+    {
+        return;
+    }
+
     int available = 0;
     if (ioctl(this->fd, FIONREAD, &available) != 0)
     {
@@ -213,6 +225,8 @@ void wf::ipc::client_t::handle_fd_incoming(uint32_t event_mask)
         return;
     }
 
+    // Responses to all messages received in this cycle are written together afterwards.
+    processing_messages = true;
     while (available > 0)
     {
         if (current_buffer_valid < HEADER_LEN)
@@ -259,7 +273,8 @@ void wf::ipc::client_t::handle_fd_incoming(uint32_t event_mask)
             json_t error;
             error["error"] = std::string("Client's message could not be parsed, error: ") + *err;
             LOGE((std::string)error["error"], ": ", str);
-            this->send_json(error);
+            this->queue_message(serialize_message(error), false);
+            flush_output();
             ipc->client_disappeared(this);
             return;
         }
@@ -273,7 +288,8 @@ void wf::ipc::client_t::handle_fd_incoming(uint32_t event_mask)
             LOGE(error["error"].as_string());
             LOGI("END");
 
-            this->send_json(error);
+            this->queue_message(serialize_message(error), false);
+            flush_output();
             ipc->client_disappeared(this);
             return;
         }
@@ -282,6 +298,9 @@ void wf::ipc::client_t::handle_fd_incoming(uint32_t event_mask)
         // Reset for next message
         current_buffer_valid = 0;
     }
+
+    processing_messages = false;
+    flush_output();
 }
 
 wf::ipc::client_t::~client_t()
@@ -291,49 +310,99 @@ wf::ipc::client_t::~client_t()
     close(this->fd);
 }
 
-static bool write_exact(int fd, const char *buf, ssize_t n)
+void wf::ipc::client_t::flush_output()
 {
-    while (n > 0)
+    if (!output.flush(fd))
     {
-        ssize_t w = write(fd, buf, n);
-        if (w <= 0)
-        {
-            return false;
-        }
+        LOGE("Error sending json to client!");
+        shutdown(fd, SHUT_RDWR);
+    }
+
+    if (output.empty() && output.dropped)
+    {
+        LOGI("IPC client ", this, " caught up, ", output.dropped, " events were dropped");
+        output.dropped = 0;
+    }
 
-        n   -= w;
-        buf += w;
+    // Wait for the socket to become writable only while there is something left to write.
+    const bool need_writable = !output.empty();
+    if (need_writable != waiting_writable)
+    {
+        waiting_writable = need_writable;
+        wl_event_source_fd_update(source, WL_EVENT_READABLE | (need_writable ? WL_EVENT_WRITABLE : 0));
     }
+}
 
-    return true;
+void wf::ipc::client_t::disconnect_slow_client()
+{
+    LOGE("IPC client ", this, " does not read its messages, disconnecting it!");
+    disconnecting = true;
+    output.clear();
+    // The client is destroyed once the event loop reports the hangup, the caller may still be using it.
+    shutdown(fd, SHUT_RDWR);
 }
 
-bool wf::ipc::client_t::send_json(wf::json_t json)
+bool wf::ipc::client_t::queue_message(const serialized_message_t& message, bool is_event)
 {
+    if (disconnecting)
+    {
+        return false;
+    }
+
+    output.high_water_mark = std::max(0, (int)ipc->max_pending_kb) * 1024;
+    if (output.high_water_mark && (output.pending() > output.high_water_mark))
+    {
+        // Responses are not flushed while processing messages, make sure only data the client has not
+        // read yet is counted.
+        flush_output();
+    }
+
+    if (message->size() > MAX_MESSAGE_LEN)
+    {
+        LOGE("Error sending json to client: message too long!");
+        shutdown(fd, SHUT_RDWR);
+        return false;
+    }
+
+    const bool droppable = is_event && ((std::string)ipc->slow_client_policy == "drop");
     bool status = false;
-    json.map_serialized([&] (const char *buffer, size_t size)
+    switch (output.push(message, droppable))
     {
-        if (size > MAX_MESSAGE_LEN)
-        {
-            LOGE("Error sending json to client: message too long!");
-            shutdown(fd, SHUT_RDWR);
-            return;
-        }
+      case output_queue_t::push_result_t::QUEUED:
+        status = true;
+        break;
 
-        uint32_t len = size;
-        if (!write_exact(fd, (char*)&len, 4) || !write_exact(fd, buffer, len))
+      case output_queue_t::push_result_t::DROPPED:
+        if (output.dropped == 1)
         {
-            LOGE("Error sending json to client!");
-            shutdown(fd, SHUT_RDWR);
-            return;
+            LOGW("IPC client ", this, " does not read its messages, dropping events!");
         }
 
-        status = true;
-    });
+        break;
+
+      case output_queue_t::push_result_t::OVERFLOW:
+        disconnect_slow_client();
+        break;
+    }
+
+    if (!processing_messages)
+    {
+        flush_output();
+    }
 
     return status;
 }
 
+bool wf::ipc::client_t::send_json(wf::json_t json)
+{
+    return queue_message(serialize_message(json), true);
+}
+
+bool wf::ipc::client_t::send_serialized(const serialized_message_t& message)
+{
+    return queue_message(message, true);
+}
+
 namespace wf
 {
 class ipc_plugin_t : public wf::plugin_interface_t
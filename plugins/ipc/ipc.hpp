@@ -4,7 +4,9 @@
 #include <wayfire/object.hpp>
 #include <wayland-server.h>
 #include <wayfire/plugins/common/shared-core-data.hpp>
+#include <wayfire/option-wrapper.hpp>
 #include "ipc-method-repository.hpp"
+#include "ipc-output-queue.hpp"
 
 namespace wf
 {
@@ -20,8 +22,10 @@ class client_t : public client_interface_t
     client_t(server_t *server, int client_fd);
     ~client_t();
     bool send_json(wf::json_t json) override;
+    bool send_serialized(const serialized_message_t& message) override;
 
   private:
+    friend class server_t;
     int fd;
     wl_event_source *source;
     server_t *ipc;
@@ -30,6 +34,26 @@ class client_t : public client_interface_t
     std::vector<char> buffer;
     int read_up_to(int n, int *available);
 
+    /**
+     * Messages which have not been written to the socket yet. The socket is
+     * non-blocking, so anything which cannot be written immediately is kept
+     * here and written as soon as the socket becomes writable again.
+     */
+    output_queue_t output;
+    bool waiting_writable = false;
+    /** Whether messages from the client are being processed, responses are flushed afterwards */
+    bool processing_messages = false;
+    /** Set when the client was too slow and is being disconnected */
+    bool disconnecting = false;
+    void flush_output();
+
+    /**
+     * Queue a message for the client. Events may be dropped if the client does not read its messages
+     * fast enough, responses to the client's requests are never dropped.
+     */
+    bool queue_message(const serialized_message_t& message, bool is_event);
+    void disconnect_slow_client();
+
     /** Handle incoming data on the socket */
     std::function<void(uint32_t)> handle_fd_activity;
     void handle_fd_incoming(uint32_t);
@@ -49,6 +73,8 @@ class server_t
   private:
     friend class client_t;
     wf::shared_data::ref_ptr_t<wf::ipc::method_repository_t> method_repository;
+    wf::option_wrapper_t<int> max_pending_kb{"ipc/max_pending_kb"};
+    wf::option_wrapper_t<std::string> slow_client_policy{"ipc/slow_client_policy"};
 
     void handle_incoming_message(client_t *client, wf::json_t message);
 
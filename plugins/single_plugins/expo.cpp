@@ -43,6 +43,7 @@ class wayfire_expo : public wf::per_output_plugin_instance_t, public wf::keyboar
     wf::option_wrapper_t<bool> keyboard_interaction{"expo/keyboard_interaction"};
     wf::option_wrapper_t<double> inactive_brightness{"expo/inactive_brightness"};
     wf::option_wrapper_t<int> transition_length{"expo/transition_length"};
+    wf::option_wrapper_t<int> workspace_buffer_budget{"expo/workspace_buffer_budget"};
     wf::geometry_animation_t zoom_animation{zoom_duration};
 
     wf::option_wrapper_t<bool> move_enable_snap_off{"move/enable_snap_off"};
@@ -310,6 +311,7 @@ class wayfire_expo : public wf::per_output_plugin_instance_t, public wf::keyboar
     {
         wall->set_background_color(background_color);
         wall->set_gap_size(this->delimiter_offset);
+        wall->set_persistent_buffers((size_t)std::max(0, (int)workspace_buffer_budget) << 20);
         if (zoom_in)
         {
             zoom_animation.set_start(wall->get_workspace_rectangle(
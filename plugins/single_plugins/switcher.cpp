@@ -1,5 +1,6 @@
 #include "wayfire/object.hpp"
 #include "wayfire/plugins/common/input-grab.hpp"
+#include "wayfire/plugins/common/offscreen-view-renderer.hpp"
 #include "wayfire/scene-input.hpp"
 #include "wayfire/scene-operations.hpp"
 #include "wayfire/scene-render.hpp"
@@ -27,6 +28,7 @@
 #include <glm/gtc/matrix_transform.hpp>
 
 #include <algorithm>
+#include <map>
 #include <set>
 
 constexpr const char *switcher_transformer = "switcher-3d";
@@ -113,6 +115,9 @@ class WayfireSwitcher : public wf::per_output_plugin_instance_t, public wf::keyb
     /* If a view comes before another in this list, it is on top of it */
     std::vector<SwitcherView> views;
 
+    /* Render instances of all views the switcher draws, kept across frames */
+    std::map<wf::view_interface_t*, std::unique_ptr<wf::offscreen_view_renderer_t>> renderers;
+
     // the modifiers which were used to activate switcher
     uint32_t activating_modifiers = 0;
     bool active = false;
@@ -231,7 +236,10 @@ class WayfireSwitcher : public wf::per_output_plugin_instance_t, public wf::keyb
     wf::effect_hook_t pre_hook = [=] ()
     {
         dim_background(background_dim);
-        wf::scene::damage_node(render_node, render_node->get_bounding_box());
+        if (duration.running() || background_dim_duration.running())
+        {
+            wf::scene::damage_node(render_node, render_node->get_bounding_box());
+        }
 
         if (!duration.running())
         {
@@ -246,6 +254,7 @@ class WayfireSwitcher : public wf::per_output_plugin_instance_t, public wf::keyb
     wf::signal::connection_t<wf::view_disappeared_signal> view_disappeared =
         [=] (wf::view_disappeared_signal *ev)
     {
+        renderers.erase(ev->view.get());
         if (auto toplevel = toplevel_cast(ev->view))
         {
             handle_view_removed(toplevel);
@@ -343,6 +352,7 @@ class WayfireSwitcher : public wf::per_output_plugin_instance_t, public wf::keyb
     /* The reverse of init_switcher */
     void deinit_switcher()
     {
+        renderers.clear();
         output->deactivate_plugin(&grab_interface);
 
         output->render->rem_effect(&pre_hook);
@@ -521,6 +531,7 @@ class WayfireSwitcher : public wf::per_output_plugin_instance_t, public wf::keyb
         duration.start();
         background_dim.set(1, background_dim_factor);
         background_dim_duration.start();
+        wf::scene::damage_node(render_node, render_node->get_bounding_box());
 
         auto ws_views = get_workspace_views();
         for (auto v : ws_views)
@@ -599,6 +610,7 @@ class WayfireSwitcher : public wf::per_output_plugin_instance_t, public wf::keyb
         background_dim_duration.start();
         duration.start();
         active = false;
+        wf::scene::damage_node(render_node, render_node->get_bounding_box());
 
         /* Potentially restore view[0] if it was maximized */
         if (views.size())
@@ -668,15 +680,19 @@ class WayfireSwitcher : public wf::per_output_plugin_instance_t, public wf::keyb
 
     void render_view_scene(wayfire_view view, const wf::render_target_t& buffer)
     {
-        std::vector<wf::scene::render_instance_uptr> instances;
-        view->get_transformed_node()->gen_render_instances(instances, [] (auto) {});
+        auto& renderer = renderers[view.get()];
+        if (!renderer)
+        {
+            /* Views are drawn with 3D transforms anywhere on the output, so any damage to them requires a
+             * full redraw of the switcher. */
+            renderer = std::make_unique<wf::offscreen_view_renderer_t>(view->get_transformed_node(),
+                output, [=] (const wf::region_t&)
+            {
+                wf::scene::damage_node(render_node, render_node->get_bounding_box());
+            });
+        }
 
-        wf::scene::render_pass_params_t params;
-        params.instances = &instances;
-        params.damage    = view->get_transformed_node()->get_bounding_box();
-        params.reference_output = this->output;
-        params.target = buffer;
-        wf::scene::run_render_pass(params, 0);
+        renderer->render(buffer);
     }
 
     void render_view(const SwitcherView& sv, const wf::render_target_t& buffer)
@@ -828,6 +844,7 @@ class WayfireSwitcher : public wf::per_output_plugin_instance_t, public wf::keyb
         rebuild_view_list();
         wf::view_bring_to_front(views.front().view);
         duration.start();
+        wf::scene::damage_node(render_node, render_node->get_bounding_box());
     }
 
     int count_different_active_views()
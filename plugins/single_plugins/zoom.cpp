@@ -1,7 +1,8 @@
 #include <wayfire/per-output-plugin.hpp>
 #include <wayfire/output.hpp>
-#include <wayfire/opengl.hpp>
+#include <wayfire/core.hpp>
 #include <wayfire/render-manager.hpp>
+#include <wayfire/signal-definitions.hpp>
 #include <wayfire/util/duration.hpp>
 
 class wayfire_zoom_screen : public wf::per_output_plugin_instance_t
@@ -29,6 +30,22 @@ class wayfire_zoom_screen : public wf::per_output_plugin_instance_t
     {
         progression.set(1, 1);
         output->add_axis(modifier, &axis);
+        interpolation_method.set_callback([=] ()
+        {
+            if (hook_set)
+            {
+                update_magnification();
+            }
+        });
+    }
+
+    void set_hook()
+    {
+        hook_set = true;
+        output->render->add_effect(&update_hook, wf::OUTPUT_EFFECT_PRE);
+        wf::get_core().connect(&on_motion);
+        wf::get_core().connect(&on_absolute_motion);
+        wf::get_core().connect(&on_tablet_axis);
     }
 
     void update_zoom_target(float delta)
@@ -43,10 +60,10 @@ class wayfire_zoom_screen : public wf::per_output_plugin_instance_t
 
             if (!hook_set)
             {
-                hook_set = true;
-                output->render->add_post(&render_hook);
-                output->render->set_redraw_always();
+                set_hook();
             }
+
+            output->render->schedule_redraw();
         }
     }
 
@@ -67,55 +84,61 @@ class wayfire_zoom_screen : public wf::per_output_plugin_instance_t
         return true;
     };
 
-    wf::post_hook_t render_hook = [=] (const wf::framebuffer_t& source,
-                                       const wf::framebuffer_t& destination)
+    /**
+     * Magnify the output around the cursor. The output is repainted only if the magnified part of the
+     * output actually changes.
+     */
+    void update_magnification()
     {
-        auto w = destination.viewport_width;
-        auto h = destination.viewport_height;
         auto oc = output->get_cursor_position();
         double x, y;
         wlr_box b = output->get_relative_geometry();
         wlr_box_closest_point(&b, oc.x, oc.y, &x, &y);
 
-        /* get rotation & scale */
-        wlr_box box = {int(x), int(y), 1, 1};
-        box = output->render->get_target_framebuffer().
-            framebuffer_box_from_geometry_box(box);
-
-        x = box.x;
-        y = h - box.y;
-
-        const float scale = (progression - 1) / progression;
-
-        // The target width and height are truncated here so that `x1+tw` and
-        // `x1` round to GLint in tandem for glBlitFramebuffer(). This keeps the
-        // aspect ratio constant while panning around.
-        const GLint tw = w / progression, th = h / progression;
-
-        const float x1 = x * scale;
-        const float y1 = y * scale;
-
-        const GLenum interpolation =
-            (interpolation_method ==
-                (int)interpolation_method_t::NEAREST) ? GL_NEAREST : GL_LINEAR;
-
-        OpenGL::render_begin(source);
-        GL_CALL(glBindFramebuffer(GL_READ_FRAMEBUFFER, source.fb));
-        GL_CALL(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, destination.fb));
-        GL_CALL(glBlitFramebuffer(x1, y1, x1 + tw, y1 + th, 0, 0, w, h,
-            GL_COLOR_BUFFER_BIT, interpolation));
-        OpenGL::render_end();
+        // Keep the point under the cursor at the same position on the screen.
+        const double scale = (progression - 1) / progression;
+        const bool nearest = (interpolation_method == (int)interpolation_method_t::NEAREST);
+        output->render->set_magnification(progression, {x * scale, y * scale}, nearest);
+    }
 
-        if (!progression.running() && (progression - 1 <= 0.01))
+    wf::effect_hook_t update_hook = [=] ()
+    {
+        update_magnification();
+        if (progression.running())
+        {
+            output->render->schedule_redraw();
+        } else if (progression - 1 <= 0.01)
         {
             unset_hook();
         }
     };
 
+    wf::signal::connection_t<wf::post_input_event_signal<wlr_pointer_motion_event>> on_motion =
+        [=] (auto)
+    {
+        update_magnification();
+    };
+
+    wf::signal::connection_t<wf::post_input_event_signal<wlr_pointer_motion_absolute_event>>
+    on_absolute_motion = [=] (auto)
+    {
+        update_magnification();
+    };
+
+    wf::signal::connection_t<wf::post_input_event_signal<wlr_tablet_tool_axis_event>> on_tablet_axis =
+        [=] (auto)
+    {
+        update_magnification();
+    };
+
     void unset_hook()
     {
-        output->render->set_redraw_always(false);
-        output->render->rem_post(&render_hook);
+        output->render->set_magnification(1.0);
+        on_motion.disconnect();
+        on_absolute_motion.disconnect();
+        on_tablet_axis.disconnect();
+
+        output->render->rem_effect(&update_hook);
         hook_set = false;
     }
 
@@ -123,7 +146,7 @@ class wayfire_zoom_screen : public wf::per_output_plugin_instance_t
     {
         if (hook_set)
         {
-            output->render->rem_post(&render_hook);
+            unset_hook();
         }
 
         output->rem_binding(&axis);
@@ -3,6 +3,7 @@
 
 #include <map>
 #include <memory>
+#include <sstream>
 #include <string>
 #include <tuple>
 
@@ -20,6 +21,24 @@ namespace wf
 {
 struct lambda_rule_registration_t;
 
+/**
+ * @brief get_rule_signal Find the signal a rule reacts to, i.e. the word after "on" at the start of the rule
+ * text. Used to skip rules which do not react to the current signal without evaluating them.
+ *
+ * @return The signal name, or an empty string if the rule text does not start with "on <signal>".
+ */
+inline std::string get_rule_signal(const std::string& rule_text)
+{
+    std::istringstream stream{rule_text};
+    std::string on, signal;
+    if ((stream >> on >> signal) && (on == "on"))
+    {
+        return signal;
+    }
+
+    return "";
+}
+
 using map_type = std::map<std::string, std::shared_ptr<lambda_rule_registration_t>>;
 
 using lambda_reg_t = std::function<bool (std::string, wayfire_view)>;
@@ -92,6 +111,11 @@ struct lambda_rule_registration_t
      */
     std::shared_ptr<wf::lambda_rule_t> rule_instance;
 
+    /**
+     * @brief signal The signal the rule reacts to, see get_rule_signal().
+     */
+    std::string signal;
+
     // Friendship for window rules to be able to execute the rules.
     friend class ::wayfire_window_rules_t;
 
@@ -171,6 +195,7 @@ class lambda_rules_registrations_t : public custom_data_t
             return true; // Error, failed to parse rule.
         }
 
+        registration->signal = get_rule_signal(registration->rule);
         _registrations.emplace(key, registration);
 
         return false;
@@ -26,6 +26,7 @@ view_action_interface_t::~view_action_interface_t()
 bool view_action_interface_t::execute(const std::string & name,
     const std::vector<variant_t> & args)
 {
+    _executed = true;
     const auto& execute_set_alpha = [&]
     {
         auto alpha = _validate_alpha(args);
@@ -238,6 +239,17 @@ void view_action_interface_t::set_view(wayfire_view view)
 {
     _nontoplevel = view;
     _view = toplevel_cast(view);
+    _executed = false;
+}
+
+bool view_action_interface_t::has_executed() const
+{
+    return _executed;
+}
+
+void view_action_interface_t::clear_executed()
+{
+    _executed = false;
 }
 
 void view_action_interface_t::_maximize()
@@ -19,6 +19,12 @@ class view_action_interface_t : public action_interface_t
 
     void set_view(wayfire_view view);
 
+    /**
+     * Check whether any action was executed since the last call to set_view() or clear_executed().
+     */
+    bool has_executed() const;
+    void clear_executed();
+
   private:
     void _maximize();
     void _unmaximize();
@@ -56,6 +62,7 @@ class view_action_interface_t : public action_interface_t
 
     wayfire_toplevel_view _view;
     wayfire_view _nontoplevel;
+    bool _executed = false;
 };
 } // End namespace wf.
 
@@ -1,4 +1,6 @@
+#include <map>
 #include <memory>
+#include <set>
 #include <vector>
 
 #include <wayfire/per-output-plugin.hpp>
@@ -58,10 +60,16 @@ class wayfire_window_rules_t : public wf::per_output_plugin_instance_t
     // Auto-reload on changes to config file
     wf::signal::connection_t<wf::reload_config_signal> _reload_config = [=] (wf::reload_config_signal *ev)
     {
-        setup_rules_from_config();
+        if (ev->option_changed("window-rules/rules"))
+        {
+            setup_rules_from_config();
+        }
     };
 
-    std::vector<std::shared_ptr<wf::rule_t>> _rules;
+    // The rules from the config, bucketed by the signal they react to. Rules whose signal cannot be determined
+    // from their text are in every bucket and in _rules_any_signal, in config order.
+    std::map<std::string, std::vector<std::shared_ptr<wf::rule_t>>> _rules_by_signal;
+    std::vector<std::shared_ptr<wf::rule_t>> _rules_any_signal;
 
     wf::view_access_interface_t _access_interface;
     wf::view_action_interface_t _action_interface;
@@ -111,17 +119,32 @@ void wayfire_window_rules_t::apply(const std::string & signal, wayfire_view view
         return;
     }
 
-    for (const auto & rule : _rules)
+    // The view's properties are read only once for all rules, unless a rule executes an action which might
+    // change them.
+    _access_interface.set_view(view);
+    _access_interface.set_caching(true);
+    _action_interface.set_view(view);
+
+    auto bucket = _rules_by_signal.find(signal);
+    const auto& rules = (bucket == _rules_by_signal.end()) ? _rules_any_signal : bucket->second;
+    for (const auto & rule : rules)
     {
-        _access_interface.set_view(view);
-        _action_interface.set_view(view);
         auto error = rule->apply(signal, _access_interface, _action_interface);
         if (error)
         {
             LOGE("Window-rules: Error while executing rule on ", signal, " signal.");
         }
+
+        if (_action_interface.has_executed())
+        {
+            _access_interface.clear_cache();
+            _action_interface.clear_executed();
+        }
     }
 
+    // Lambdas can do anything with the view, so we don't cache properties for them.
+    _access_interface.set_caching(false);
+
     auto bounds = _lambda_registrations->rules();
     auto begin  = std::get<0>(bounds);
     auto end    = std::get<1>(bounds);
@@ -130,6 +153,12 @@ void wayfire_window_rules_t::apply(const std::string & signal, wayfire_view view
         auto registration = std::get<1>(*begin);
         bool error = false;
 
+        if (!registration->signal.empty() && (registration->signal != signal))
+        {
+            ++begin;
+            continue;
+        }
+
         // Assume we will use the view access interface.
         _access_interface.set_view(view);
         wf::access_interface_t & access_iface = _access_interface;
@@ -179,19 +208,44 @@ void wayfire_window_rules_t::apply(const std::string & signal, wayfire_view view
 
 void wayfire_window_rules_t::setup_rules_from_config()
 {
-    _rules.clear();
+    _rules_by_signal.clear();
+    _rules_any_signal.clear();
 
     wf::option_wrapper_t<wf::config::compound_list_t<std::string>> rule_list_option{"window-rules/rules"};
     auto rule_list = rule_list_option.value();
 
+    std::set<std::string> signals;
+    for (const auto& [name, rule_str] : rule_list)
+    {
+        auto signal = wf::get_rule_signal(rule_str);
+        if (!signal.empty())
+        {
+            signals.insert(signal);
+        }
+    }
+
     for (const auto& [name, rule_str] : rule_list)
     {
         LOGD("Registering ", rule_str);
         _lexer.reset(rule_str);
         auto rule = wf::rule_parser_t().parse(_lexer);
-        if (rule != nullptr)
+        if (rule == nullptr)
         {
-            _rules.push_back(rule);
+            continue;
+        }
+
+        auto signal = wf::get_rule_signal(rule_str);
+        if (!signal.empty())
+        {
+            _rules_by_signal[signal].push_back(rule);
+        } else
+        {
+            for (auto& s : signals)
+            {
+                _rules_by_signal[s].push_back(rule);
+            }
+
+            _rules_any_signal.push_back(rule);
         }
     }
 }
@@ -45,6 +45,10 @@ class view_matcher_t
 
     /**
      * @return True if the view matches the condition specified, false otherwise.
+     *
+     * The results are cached per view and shared by all matchers with the same condition. The cache of a view
+     * is dropped when its title, app-id, role, layer, focusability, state (mapped, activated, minimized,
+     * pending tiled edges and fullscreen) or output changes.
      */
     bool matches(wayfire_view view);
 
@@ -57,4 +61,17 @@ class view_matcher_t
     class impl;
     std::unique_ptr<impl> priv;
 };
+
+/**
+ * Statistics about the cache of view_matcher_t results.
+ */
+struct view_matcher_cache_stats_t
+{
+    /** The number of matches() calls answered from the cache. */
+    uint64_t hits = 0;
+    /** The number of matches() calls which had to evaluate the condition. */
+    uint64_t misses = 0;
+};
+
+view_matcher_cache_stats_t get_view_matcher_cache_stats();
 }
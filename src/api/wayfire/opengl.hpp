@@ -283,6 +283,17 @@ void render_texture(wf::texture_t texture,
     glm::vec4 color = glm::vec4(1.f),
     uint32_t bits   = 0);
 
+/**
+ * Force the filter with which textures are magnified (GL_TEXTURE_MAG_FILTER)
+ * by the following draws, for example GL_NEAREST while the output is zoomed
+ * in. 0 restores the default: GL_LINEAR, unless the node rendering the texture
+ * chooses another filter.
+ */
+void set_texture_mag_filter(GLint filter);
+
+/** @return The filter set with set_texture_mag_filter(), or 0. */
+GLint get_texture_mag_filter();
+
 /**
  * Render the textured rectangle again.
  *
@@ -317,6 +328,43 @@ GLuint compile_program(std::string vertex_source, std::string frag_source);
  */
 void render_rectangle(wf::geometry_t box, wf::color_t color, glm::mat4 matrix);
 
+/**
+ * Get a framebuffer from the shared framebuffer pool.
+ *
+ * The pool keeps released framebuffers and hands them out again, so that
+ * plugins which need temporary buffers every frame do not have to keep their
+ * own. Sizes are rounded up to buckets, so the framebuffer may be bigger than
+ * requested; its viewport_width/height are set to the actual size. The
+ * contents of the framebuffer are undefined.
+ *
+ * @param width The minimal width of the framebuffer.
+ * @param height The minimal height of the framebuffer.
+ */
+wf::framebuffer_t acquire_pooled_framebuffer(int width, int height);
+
+/**
+ * Return a framebuffer obtained via acquire_pooled_framebuffer() to the pool,
+ * and reset @fb. Framebuffers which stay unused in the pool for more than a
+ * second are freed by a timer, even if no more framebuffers are acquired.
+ */
+void release_pooled_framebuffer(wf::framebuffer_t& fb);
+
+struct framebuffer_pool_stats_t
+{
+    /** The number of framebuffers currently acquired */
+    size_t used_buffers = 0;
+    /** The number of framebuffers kept in the pool for reuse */
+    size_t free_buffers = 0;
+    /** The memory used by all framebuffers of the pool, in bytes */
+    size_t total_bytes  = 0;
+    /** The number of acquisitions which reused a framebuffer from the pool */
+    uint64_t hits = 0;
+    /** The number of acquisitions which had to allocate a new framebuffer */
+    uint64_t misses = 0;
+};
+
+framebuffer_pool_stats_t get_framebuffer_pool_stats();
+
 /**
  * An OpenGL program for rendering texture_t.
  * It contains multiple programs for the different texture types.
@@ -53,6 +53,63 @@ using post_hook_t = std::function<void (const wf::framebuffer_t& source,
 struct frame_done_signal
 {};
 
+/**
+ * The phases of the repaint cycle of an output, in the order they are executed.
+ */
+enum frame_phase_t
+{
+    /* PRE and DAMAGE effect hooks, and POST hooks after the frame */
+    FRAME_PHASE_EFFECTS     = 0,
+    /* Attempt to directly scan out a surface */
+    FRAME_PHASE_SCANOUT     = 1,
+    /* Acquiring a buffer and rendering the scenegraph */
+    FRAME_PHASE_RENDER      = 2,
+    /* OVERLAY effect hooks */
+    FRAME_PHASE_OVERLAY     = 3,
+    /* Postprocessing hooks and software cursors */
+    FRAME_PHASE_POSTPROCESS = 4,
+    /* Submitting the frame to the output */
+    FRAME_PHASE_SWAP        = 5,
+    /* Invalid phase, used internally */
+    FRAME_PHASE_TOTAL       = 6,
+};
+
+/**
+ * Timing information about a single frame, see render_manager::get_frame_stats().
+ * All times are in nanoseconds.
+ */
+struct frame_timing_t
+{
+    /* The time (CLOCK_MONOTONIC) when the repaint of the frame started */
+    int64_t start = 0;
+    /* The CPU time spent in each phase, 0 for phases which were not executed */
+    int64_t cpu_ns[FRAME_PHASE_TOTAL] = {0};
+    /* The GPU time spent in the render, overlay and postprocessing phases, or -1 if unknown */
+    int64_t gpu_ns = -1;
+    /* Whether the frame was directly scanned out */
+    bool scanout = false;
+    /* The number of rectangles in the damage of the frame, and after merging them (see core/damage_max_rects) */
+    int damage_rects = 0;
+    int damage_rects_merged = 0;
+};
+
+/**
+ * Statistics about the frames repainted on an output.
+ */
+struct frame_stats_t
+{
+    /* The most recent frames, oldest first */
+    std::vector<frame_timing_t> frames;
+    /* Total number of frames which were rendered or scanned out */
+    uint64_t painted = 0;
+    /* Total number of frame events which did not result in a new frame because there was no damage */
+    uint64_t skipped = 0;
+    /* Total number of frames which were directly scanned out */
+    uint64_t scanout = 0;
+    /* Whether the GPU supports timer queries, i.e whether frame_timing_t::gpu_ns is available */
+    bool gpu_timers = false;
+};
+
 /** Render manager
  *
  * Each output has a render manager, which is responsible for all rendering
@@ -173,12 +230,30 @@ class render_manager
      */
     wf::render_target_t get_target_framebuffer() const;
 
+    /**
+     * Magnify the contents of the output. The scenegraph is rendered directly at the magnified size, so only
+     * the visible part of the output is repainted, and damage is mapped to the screen through the
+     * magnification. Overlay and postprocessing effects are not magnified. While overlay effects are active,
+     * the part of the output under their damage on the screen is repainted as well.
+     *
+     * @param factor The magnification factor, 1 disables magnification.
+     * @param origin The point (in output-local coordinates) which is shown at the top-left corner of the
+     *   output.
+     * @param nearest Whether to magnify with nearest-neighbour instead of linear interpolation.
+     */
+    void set_magnification(double factor, wf::pointf_t origin = {0, 0}, bool nearest = false);
+
     /**
      * Inform Wayfire whether a depth buffer is required for rendering on the default framebuffer for each
      * output.
      */
     void set_require_depth_buffer(bool require);
 
+    /**
+     * @return Timing information about the last frames repainted on the output.
+     */
+    frame_stats_t get_frame_stats() const;
+
   public:
     class impl;
     std::unique_ptr<impl> pimpl;
@@ -270,6 +270,17 @@ struct render_pass_params_t
 wf::region_t run_render_pass(
     const render_pass_params_t& params, uint32_t flags);
 
+/**
+ * Get the number of times the storage for render instructions had to be
+ * allocated or grown by run_render_pass(). The storage is reused between
+ * render passes, so once the scene is in a steady state, this number should
+ * not change from frame to frame.
+ *
+ * The counter is only maintained in debug builds (without NDEBUG), otherwise
+ * it is always 0.
+ */
+uint64_t get_render_pass_allocations();
+
 /**
  * A helper function for direct scanout implementations.
  * It tries to forward the direct scanout request to the first render instance
@@ -331,8 +342,40 @@ class simple_render_instance_t : public render_instance_t
  * are updated, these nodes update only their internal list of children and not the entire scenegraph.
  */
 struct node_regen_instances_signal
-{};
+{
+    /**
+     * Set to true by the render instances which regenerated their list of children in response to the
+     * signal. If the signal was emitted because the node's own list of children changed, this means that
+     * the render instances of the node's parents do not need to be regenerated.
+     */
+    bool handled = false;
+};
 
 uint32_t optimize_nested_render_instances(wf::scene::node_ptr node, uint32_t flags);
+
+/**
+ * Describes which render instances in a list of children instances were generated by which child node,
+ * see @regen_children_instances().
+ */
+struct child_instances_t
+{
+    node_t *node;
+    uint64_t generation;
+    size_t count;
+};
+
+/**
+ * A helper for render instances which keep the instances of their node's children in a separate list.
+ *
+ * It (re)generates the instances for all enabled children of @node. Instances of children which were present
+ * in the previous list and whose instances generation (see node_t::get_instances_generation()) did not
+ * change are reused, so that a change to a single child does not require regenerating the whole subtree.
+ *
+ * @param instances The list of children instances, updated in place.
+ * @param children_info Information about the instances of each child, updated in place. It should be
+ *   empty the first time the function is called, and not be modified by the caller afterwards.
+ */
+void regen_children_instances(node_t *node, std::vector<render_instance_uptr>& instances,
+    std::vector<child_instances_t>& children_info, damage_callback push_damage, wf::output_t *shown_on);
 }
 }
@@ -352,6 +352,18 @@ class node_t : public std::enable_shared_from_this<node_t>,
      */
     virtual uint32_t optimize_update(uint32_t update_flags);
 
+    /**
+     * Get the generation of the node's render instances. It changes every time the render instances of the
+     * node need to be regenerated, because the node's children or enabled state changed (see @update()).
+     *
+     * Render instances which keep the instances of their children in a separate list can use it to
+     * regenerate only the instances of the children which changed, see @regen_children_instances().
+     */
+    uint64_t get_instances_generation() const
+    {
+        return instances_generation;
+    }
+
   public:
     node_t(const node_t&) = delete;
     node_t(node_t&&) = delete;
@@ -362,8 +374,10 @@ class node_t : public std::enable_shared_from_this<node_t>,
     bool _is_structure;
     int enabled_counter = 1;
     node_t *_parent     = nullptr;
+    uint64_t instances_generation;
     friend class surface_root_node_t;
     friend class floating_inner_node_t;
+    friend void update(node_ptr changed_node, uint32_t flags);
 
     // A helper functions for stringify() implementations, serializes the flags()
     // to a string, e.g. node with KEYBOARD and USER_INPUT -> '(ku)'
@@ -437,6 +451,12 @@ class output_node_t : public floating_inner_node_t
     wf::geometry_t get_bounding_box() override;
     std::optional<input_node_t> find_node_at(const wf::pointf_t& at) override;
 
+    /**
+     * The output's render instance keeps its children in a separate list, so
+     * changes to the children are handled by regenerating only that list.
+     */
+    uint32_t optimize_update(uint32_t flags) override;
+
     /**
      * Get the output this node is responsible for.
      */
@@ -3,6 +3,7 @@
 
 #include "wayfire/view.hpp"
 #include "wayfire/output.hpp"
+#include <algorithm>
 
 /**
  * Documentation of signals emitted from core components.
@@ -192,7 +193,31 @@ struct touch_focus_changed_signal
  * when: When the config file is reloaded
  */
 struct reload_config_signal
-{};
+{
+    /**
+     * The options whose value changed ("section/option"), and the names of the sections which were added or
+     * removed. If empty, the changes are not known and listeners should assume that everything changed.
+     */
+    std::vector<std::string> changed;
+
+    /**
+     * Check whether an option in a section whose name starts with @prefix changed, or whether such a section
+     * was added or removed.
+     */
+    bool section_changed(const std::string& prefix) const
+    {
+        return changed.empty() || std::any_of(changed.begin(), changed.end(), [&] (const std::string& name)
+        {
+            return name.compare(0, prefix.size(), prefix) == 0;
+        });
+    }
+
+    /** Check whether the given option ("section/option") changed. */
+    bool option_changed(const std::string& option) const
+    {
+        return changed.empty() || (std::find(changed.begin(), changed.end(), option) != changed.end());
+    }
+};
 
 /**
  * on: core
@@ -242,6 +267,24 @@ struct output_start_rendering_signal
     wf::output_t *output;
 };
 
+/**
+ * on: output
+ * when: Whenever a part of the output is damaged, for example because a node in the scenegraph changed, or
+ *   because a plugin damaged the output directly. The signal is emitted synchronously from the damage
+ *   callbacks, so listeners can find out where damage comes from.
+ */
+struct output_damage_signal
+{
+    output_damage_signal(wf::output_t *output, const wf::region_t& region) :
+        output(output), region(region)
+    {}
+
+    wf::output_t *output;
+
+    /** The damaged region, in output-local coordinates. */
+    const wf::region_t& region;
+};
+
 /* ----------------------------------------------------------------------------/
  * Output workspace signals
  * -------------------------------------------------------------------------- */
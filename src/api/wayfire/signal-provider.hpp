@@ -3,7 +3,9 @@
 #include <functional>
 #include <memory>
 #include <cassert>
+#include <cstdint>
 #include <typeindex>
+#include <vector>
 
 namespace wf
 {
@@ -117,6 +119,66 @@ class connection_t final : public connection_base_t
     callback current_callback;
 };
 
+namespace detail
+{
+/**
+ * Get a unique id for the type with the given type_info.
+ *
+ * Ids are assigned at runtime on first use, because plugins are separate
+ * shared objects, so neither the address of a per-type variable nor the
+ * address of its type_info is guaranteed to be the same everywhere.
+ */
+uint32_t register_signal_type(const std::type_index& type);
+
+/**
+ * Get the id of the given signal type. The lookup happens only the first time
+ * a signal type is used, afterwards the id is just loaded from a static variable.
+ */
+template<class SignalType>
+inline uint32_t signal_type_id()
+{
+    static const uint32_t id = register_signal_type(typeid(SignalType));
+    return id;
+}
+
+/**
+ * The connections to a single signal type on a provider.
+ *
+ * Connections may be added or removed while the list is being iterated, in
+ * which case removed connections are only cleared and erased after the
+ * iteration ends, and connections added during the iteration are not called.
+ */
+struct connection_list_t
+{
+    uint32_t type;
+    std::vector<connection_base_t*> connections;
+    int iterating     = 0;
+    bool has_removed  = false;
+
+    template<class Func>
+    void for_each(const Func& func)
+    {
+        ++iterating;
+        const size_t size = connections.size();
+        for (size_t i = 0; i < size; i++)
+        {
+            if (connections[i])
+            {
+                func(connections[i]);
+            }
+        }
+
+        if ((--iterating == 0) && has_removed)
+        {
+            compact();
+        }
+    }
+
+    void remove_all(connection_base_t *connection);
+    void compact();
+};
+}
+
 class provider_t
 {
   public:
@@ -134,7 +196,7 @@ class provider_t
     template<class SignalType>
     void connect(connection_t<SignalType> *callback)
     {
-        connect_base(index<SignalType>(), callback);
+        connect_base(detail::signal_type_id<SignalType>(), callback);
     }
 
     /** Unregister a connection. */
@@ -144,11 +206,16 @@ class provider_t
     template<class SignalType>
     void emit(SignalType *data)
     {
-        this->for_each_connection(index<SignalType>(), [&] (connection_base_t *tc)
+        auto list = find_connections(detail::signal_type_id<SignalType>());
+        if (!list)
+        {
+            return;
+        }
+
+        // Connections are stored by their signal type, so the static_cast is safe.
+        list->for_each([&] (connection_base_t *tc)
         {
-            auto real_type = dynamic_cast<connection_t<SignalType>*>(tc);
-            assert(real_type);
-            real_type->emit(data);
+            static_cast<connection_t<SignalType>*>(tc)->emit(data);
         });
     }
 
@@ -164,14 +231,9 @@ class provider_t
     provider_t& operator =(provider_t&& other) = delete;
 
   private:
-    template<class SignalType>
-    static inline std::type_index index()
-    {
-        return std::type_index(typeid(SignalType));
-    }
-
-    void connect_base(std::type_index type, connection_base_t *callback);
-    void for_each_connection(std::type_index type, std::function<void(connection_base_t*)> func);
+    void connect_base(uint32_t type, connection_base_t *callback);
+    /** Find the list of connections for the given signal type, or nullptr if there are none. */
+    detail::connection_list_t *find_connections(uint32_t type);
     void disconnect_other_side(connection_base_t *callback);
 
     struct impl;
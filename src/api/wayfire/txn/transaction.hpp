@@ -3,6 +3,7 @@
 #include "wayfire/signal-provider.hpp"
 #include "wayfire/util.hpp"
 #include <wayfire/txn/transaction-object.hpp>
+#include <unordered_set>
 
 namespace wf
 {
@@ -54,6 +55,7 @@ class transaction_t : public signal::provider_t
 
   private:
     std::vector<transaction_object_sptr> objects;
+    std::unordered_set<transaction_object_t*> object_set;
     int count_ready_objects = 0;
     uint64_t timeout;
     timer_setter_t timer_setter;
@@ -14,6 +14,7 @@ class translation_node_t : public wf::scene::floating_inner_node_t
 {
   public:
     translation_node_t(bool is_structure = false);
+    ~translation_node_t();
 
     /**
      * Set the offset the node applies to its children.
@@ -26,7 +27,22 @@ class translation_node_t : public wf::scene::floating_inner_node_t
      */
     wf::point_t get_offset() const;
 
+    /**
+     * Enable or disable a spatial index of the node's children, which makes
+     * find_node_at() sub-linear in the number of children. It is useful for
+     * nodes with many children, for example workspace sets.
+     *
+     * The index assumes that every child accepts input only inside its
+     * bounding box. It is rebuilt lazily after the list of children, or the
+     * geometry or enabled state of the children change, as reported by
+     * scene::update(). Damage alone does not invalidate the index. Children
+     * with transformers are checked on each lookup instead, because
+     * transformers are often changed without scene::update().
+     */
+    void set_spatial_index(bool enabled);
+
   public: // Implementation of node_t interface
+    std::optional<input_node_t> find_node_at(const wf::pointf_t& at) override;
     wf::pointf_t to_local(const wf::pointf_t& point) override;
     wf::pointf_t to_global(const wf::pointf_t& point) override;
 
@@ -38,12 +54,20 @@ class translation_node_t : public wf::scene::floating_inner_node_t
 
   protected:
     wf::point_t offset = {0, 0};
+
+  private:
+    struct spatial_index_t;
+    std::unique_ptr<spatial_index_t> spatial_index;
+    wf::signal::connection_t<node_regen_instances_signal> on_children_changed;
+    void invalidate_spatial_index();
+    friend class translation_node_instance_t;
 };
 
 class translation_node_instance_t : public render_instance_t
 {
   protected:
     std::vector<render_instance_uptr> children;
+    std::vector<child_instances_t> children_info;
     damage_callback push_damage;
     std::shared_ptr<translation_node_t> self;
     wf::signal::connection_t<wf::scene::node_damage_signal> on_node_damage;
@@ -2,6 +2,8 @@
 
 #include "wayfire/condition/access_interface.hpp"
 #include "wayfire/view.hpp"
+#include <array>
+#include <optional>
 #include <string>
 #include <tuple>
 
@@ -60,11 +62,51 @@ class view_access_interface_t : public access_interface_t
      */
     void set_view(wayfire_view view);
 
+    /**
+     * @brief set_caching Enable or disable caching of property values.
+     *
+     * While caching is enabled, each property is read from the view only once, until the view is changed
+     * with set_view() or the cache is cleared. This is useful when evaluating many conditions against the
+     * same view, for example when applying all window rules to a newly mapped view.
+     *
+     * @param[in] enabled Whether caching should be enabled.
+     */
+    void set_caching(bool enabled);
+
+    /**
+     * @brief clear_cache Drop all cached property values, for example after the view's state was changed.
+     */
+    void clear_cache();
+
   private:
+    enum class property_t
+    {
+        APP_ID,
+        TITLE,
+        ROLE,
+        FULLSCREEN,
+        ACTIVATED,
+        MINIMIZED,
+        FOCUSABLE,
+        MAPPED,
+        TILED_LEFT,
+        TILED_RIGHT,
+        TILED_TOP,
+        TILED_BOTTOM,
+        MAXIMIZED,
+        FLOATING,
+        TYPE,
+        COUNT,
+    };
+
+    variant_t get_property(property_t property, bool & error);
 
     /**
      * @brief _view The view to interrogate.
      */
     wayfire_view _view;
+
+    bool _caching = false;
+    std::array<std::optional<variant_t>, (size_t)property_t::COUNT> _cache;
 };
 } // End namespace wf.
@@ -190,9 +190,11 @@ class transformer_render_instance_t : public render_instance_t
     wf::output_t *_shown_on;
     damage_callback _push_damage;
 
-    wf::signal::connection_t<node_regen_instances_signal> on_regen_instances = [=] (auto)
+    wf::signal::connection_t<node_regen_instances_signal> on_regen_instances =
+        [=] (node_regen_instances_signal *ev)
     {
         regen_instances();
+        ev->handled = true;
     };
 
   public:
@@ -349,6 +351,14 @@ class transform_manager_node_t : public wf::scene::floating_inner_node_t
         return nullptr;
     }
 
+    /**
+     * Check whether any transformers have been added to the transform manager.
+     */
+    bool has_transformers() const
+    {
+        return !transformers.empty();
+    }
+
     std::string stringify() const override
     {
         return "view-transform-root";
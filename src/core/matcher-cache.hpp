@@ -0,0 +1,72 @@
+#pragma once
+
+#include <wayfire/object.hpp>
+#include <wayfire/signal-definitions.hpp>
+#include <wayfire/toplevel-view.hpp>
+#include <wayfire/view-helpers.hpp>
+#include <optional>
+#include <unordered_map>
+
+namespace wf
+{
+/**
+ * The results of the matchers evaluated for a view, keyed by the condition text, so that matchers with the
+ * same condition in different plugins share them. Stored on the view, and cleared whenever a property which
+ * conditions can check changes.
+ */
+class matcher_cache_t : public wf::custom_data_t
+{
+  public:
+    std::unordered_map<std::string, bool> results;
+
+    matcher_cache_t(wayfire_view view)
+    {
+        view->connect(&on_title_changed);
+        view->connect(&on_app_id_changed);
+        view->connect(&on_mapped);
+        view->connect(&on_unmapped);
+        view->connect(&on_set_output);
+        view->connect(&on_activated);
+        view->connect(&on_minimized);
+        validate(view);
+    }
+
+    /**
+     * Conditions check the pending tiled and fullscreen state, which plugins set directly, as well as the
+     * layer of the view (for its type) and whether it is focusable, which change without a signal.
+     * Drop the results if any of them changed since they were computed.
+     */
+    void validate(wayfire_view view)
+    {
+        auto toplevel = toplevel_cast(view);
+        const uint32_t edges = toplevel ? toplevel->pending_tiled_edges() : 0;
+        const bool is_fullscreen = toplevel ? toplevel->pending_fullscreen() : false;
+        const auto current_layer = get_view_layer(view);
+        const bool is_focusable  = view->is_focusable();
+        if ((edges != tiled_edges) || (is_fullscreen != fullscreen) || (current_layer != layer) ||
+            (is_focusable != focusable))
+        {
+            results.clear();
+            tiled_edges = edges;
+            fullscreen  = is_fullscreen;
+            layer     = current_layer;
+            focusable = is_focusable;
+        }
+    }
+
+  private:
+    uint32_t tiled_edges = 0;
+    bool fullscreen = false;
+    std::optional<wf::scene::layer> layer;
+    bool focusable = false;
+
+    wf::signal::connection_t<wf::view_title_changed_signal> on_title_changed = [=] (auto) { results.clear(); };
+    wf::signal::connection_t<wf::view_app_id_changed_signal> on_app_id_changed =
+        [=] (auto) { results.clear(); };
+    wf::signal::connection_t<wf::view_mapped_signal> on_mapped = [=] (auto) { results.clear(); };
+    wf::signal::connection_t<wf::view_unmapped_signal> on_unmapped = [=] (auto) { results.clear(); };
+    wf::signal::connection_t<wf::view_set_output_signal> on_set_output = [=] (auto) { results.clear(); };
+    wf::signal::connection_t<wf::view_activated_state_signal> on_activated = [=] (auto) { results.clear(); };
+    wf::signal::connection_t<wf::view_minimized_signal> on_minimized = [=] (auto) { results.clear(); };
+};
+}
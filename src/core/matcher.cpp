@@ -5,6 +5,9 @@
 #include <wayfire/condition/condition.hpp>
 #include <wayfire/view-access-interface.hpp>
 #include <wayfire/parser/condition_parser.hpp>
+#include "matcher-cache.hpp"
+
+static wf::view_matcher_cache_stats_t cache_stats;
 
 class wf::view_matcher_t::impl
 {
@@ -14,12 +17,15 @@ class wf::view_matcher_t::impl
     wf::lexer_t lexer;
     wf::condition_parser_t parser;
     std::shared_ptr<wf::condition_t> condition;
+    // The text the condition was parsed from, used as a key in the shared cache.
+    std::string condition_text;
 
     bool try_parse(const std::string& value, const std::string& opt_name)
     {
         lexer.reset(value);
         try {
             condition = parser.parse(lexer);
+            condition_text = value;
 
             return true;
         } catch (std::runtime_error& error)
@@ -110,15 +116,45 @@ void wf::view_matcher_t::set_from_option(
 
 bool wf::view_matcher_t::matches(wayfire_view view)
 {
-    if (this->priv->condition)
+    if (!this->priv->condition)
+    {
+        return false;
+    }
+
+    if (!view)
     {
         bool ignored = false;
         wf::view_access_interface_t access_interface{view};
-
         return this->priv->condition->evaluate(access_interface, ignored);
     }
 
-    return false;
+    auto cache = view->get_data<matcher_cache_t>();
+    if (!cache)
+    {
+        view->store_data(std::make_unique<matcher_cache_t>(view));
+        cache = view->get_data<matcher_cache_t>();
+    }
+
+    cache->validate(view);
+
+    auto it = cache->results.find(priv->condition_text);
+    if (it != cache->results.end())
+    {
+        ++cache_stats.hits;
+        return it->second;
+    }
+
+    ++cache_stats.misses;
+    bool ignored = false;
+    wf::view_access_interface_t access_interface{view};
+    bool result = this->priv->condition->evaluate(access_interface, ignored);
+    cache->results[priv->condition_text] = result;
+    return result;
+}
+
+wf::view_matcher_cache_stats_t wf::get_view_matcher_cache_stats()
+{
+    return cache_stats;
 }
 
 wf::view_matcher_t::~view_matcher_t() = default;
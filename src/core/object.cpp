@@ -1,11 +1,60 @@
 #include "wayfire/object.hpp"
 #include <unordered_map>
 #include <wayfire/signal-provider.hpp>
-#include <wayfire/nonstd/safe-list.hpp>
+#include <algorithm>
+
+uint32_t wf::signal::detail::register_signal_type(const std::type_index& type)
+{
+    static std::unordered_map<std::type_index, uint32_t> ids;
+    auto it = ids.find(type);
+    if (it != ids.end())
+    {
+        return it->second;
+    }
+
+    const uint32_t id = ids.size();
+    ids[type] = id;
+    return id;
+}
+
+void wf::signal::detail::connection_list_t::remove_all(connection_base_t *connection)
+{
+    if (iterating)
+    {
+        for (auto& c : connections)
+        {
+            if (c == connection)
+            {
+                c = nullptr;
+                has_removed = true;
+            }
+        }
+    } else
+    {
+        auto it = std::remove(connections.begin(), connections.end(), connection);
+        connections.erase(it, connections.end());
+    }
+}
+
+void wf::signal::detail::connection_list_t::compact()
+{
+    auto it = std::remove(connections.begin(), connections.end(), nullptr);
+    connections.erase(it, connections.end());
+    has_removed = false;
+}
 
 struct wf::signal::provider_t::impl
 {
-    std::unordered_map<std::type_index, wf::safe_list_t<connection_base_t*>> typed_connections;
+    // Sorted by type, so that lookups can use binary search. The lists are
+    // allocated separately, so that they stay valid while connecting to other
+    // signal types during an emission.
+    std::vector<std::unique_ptr<detail::connection_list_t>> typed_connections;
+
+    decltype(typed_connections)::iterator lower_bound(uint32_t type)
+    {
+        return std::lower_bound(typed_connections.begin(), typed_connections.end(), type,
+            [] (const auto& list, uint32_t type) { return list->type < type; });
+    }
 };
 
 wf::signal::provider_t::provider_t()
@@ -15,9 +64,9 @@ wf::signal::provider_t::provider_t()
 
 wf::signal::provider_t::~provider_t()
 {
-    for (auto& [id, connected] : priv->typed_connections)
+    for (auto& list : priv->typed_connections)
     {
-        connected.for_each([&] (connection_base_t *base) { disconnect_other_side(base); });
+        list->for_each([&] (connection_base_t *base) { disconnect_other_side(base); });
     }
 }
 
@@ -27,16 +76,29 @@ void wf::signal::provider_t::disconnect_other_side(connection_base_t *callback)
     callback->connected_to.erase(it, callback->connected_to.end());
 }
 
-void wf::signal::provider_t::connect_base(std::type_index idx, connection_base_t *callback)
+void wf::signal::provider_t::connect_base(uint32_t type, connection_base_t *callback)
 {
-    priv->typed_connections[idx].push_back(callback);
+    auto it = priv->lower_bound(type);
+    if ((it == priv->typed_connections.end()) || ((*it)->type != type))
+    {
+        auto list = std::make_unique<detail::connection_list_t>();
+        list->type = type;
+        it = priv->typed_connections.insert(it, std::move(list));
+    }
+
+    (*it)->connections.push_back(callback);
     callback->connected_to.push_back(this);
 }
 
-void wf::signal::provider_t::for_each_connection(
-    std::type_index type, std::function<void(connection_base_t*)> func)
+wf::signal::detail::connection_list_t *wf::signal::provider_t::find_connections(uint32_t type)
 {
-    priv->typed_connections[type].for_each(func);
+    auto it = priv->lower_bound(type);
+    if ((it == priv->typed_connections.end()) || ((*it)->type != type))
+    {
+        return nullptr;
+    }
+
+    return it->get();
 }
 
 void wf::signal::connection_base_t::disconnect()
@@ -51,9 +113,9 @@ void wf::signal::connection_base_t::disconnect()
 void wf::signal::provider_t::disconnect(connection_base_t *callback)
 {
     disconnect_other_side(callback);
-    for (auto& [id, connected] : priv->typed_connections)
+    for (auto& list : priv->typed_connections)
     {
-        connected.remove_all(callback);
+        list->remove_all(callback);
     }
 }
 
@@ -1,4 +1,5 @@
 #include <wayfire/util/log.hpp>
+#include <wayfire/util.hpp>
 #include <map>
 #include "opengl-priv.hpp"
 #include "wayfire/geometry.hpp"
@@ -7,6 +8,8 @@
 #include "config.h"
 #include <wayfire/nonstd/wlroots-full.hpp>
 #include <set>
+#include <limits>
+#include <algorithm>
 
 #include <glm/gtc/matrix_transform.hpp>
 
@@ -122,11 +125,134 @@ void init()
     render_end();
 }
 
+namespace
+{
+struct pooled_framebuffer_t
+{
+    wf::framebuffer_t fb;
+    int64_t last_used;
+};
+
+struct framebuffer_pool_t
+{
+    // Free framebuffers, by bucket size
+    std::map<std::pair<int, int>, std::vector<pooled_framebuffer_t>> free;
+    framebuffer_pool_stats_t stats;
+    // Frees the idle framebuffers while there are free framebuffers, even if nothing acquires new ones.
+    // Created on the first release, so that the global pool does not outlive the event loop with it.
+    std::unique_ptr<wf::wl_timer<true>> trim_timer;
+} framebuffer_pool;
+
+// Bucket sizes are multiples of this, so that slightly different damage sizes
+// from frame to frame can reuse the same buffers.
+constexpr int POOL_BUCKET_GRANULARITY = 128;
+// Free framebuffers unused for this long (in milliseconds) are destroyed.
+constexpr int64_t POOL_MAX_IDLE_TIME = 1000;
+
+int round_to_bucket(int size)
+{
+    size = std::max(size, 1);
+    return POOL_BUCKET_GRANULARITY * ((size + POOL_BUCKET_GRANULARITY - 1) / POOL_BUCKET_GRANULARITY);
+}
+
+size_t framebuffer_size_bytes(const wf::framebuffer_t& fb)
+{
+    return 4ul * fb.viewport_width * fb.viewport_height;
+}
+
+void trim_framebuffer_pool(int64_t min_last_used)
+{
+    auto& pool = framebuffer_pool;
+    for (auto it = pool.free.begin(); it != pool.free.end();)
+    {
+        auto& list = it->second;
+        auto expired = std::remove_if(list.begin(), list.end(), [&] (pooled_framebuffer_t& buffer)
+        {
+            if (buffer.last_used >= min_last_used)
+            {
+                return false;
+            }
+
+            pool.stats.free_buffers--;
+            pool.stats.total_bytes -= framebuffer_size_bytes(buffer.fb);
+            buffer.fb.release();
+            return true;
+        });
+
+        list.erase(expired, list.end());
+        it = list.empty() ? pool.free.erase(it) : std::next(it);
+    }
+}
+}
+
+wf::framebuffer_t acquire_pooled_framebuffer(int width, int height)
+{
+    auto& pool = framebuffer_pool;
+    trim_framebuffer_pool(wf::get_current_time() - POOL_MAX_IDLE_TIME);
+
+    const std::pair<int, int> bucket = {round_to_bucket(width), round_to_bucket(height)};
+    auto it = pool.free.find(bucket);
+    if ((it != pool.free.end()) && !it->second.empty())
+    {
+        // Take the most recently used buffer, so that rarely used ones expire.
+        auto fb = it->second.back().fb;
+        it->second.pop_back();
+        pool.stats.free_buffers--;
+        pool.stats.used_buffers++;
+        pool.stats.hits++;
+        return fb;
+    }
+
+    wf::framebuffer_t fb;
+    fb.allocate(bucket.first, bucket.second);
+    pool.stats.used_buffers++;
+    pool.stats.total_bytes += framebuffer_size_bytes(fb);
+    pool.stats.misses++;
+    return fb;
+}
+
+void release_pooled_framebuffer(wf::framebuffer_t& fb)
+{
+    if (fb.fb == (uint32_t)-1)
+    {
+        return;
+    }
+
+    auto& pool = framebuffer_pool;
+    pool.free[{fb.viewport_width, fb.viewport_height}].push_back({fb, wf::get_current_time()});
+    pool.stats.used_buffers--;
+    pool.stats.free_buffers++;
+    fb.reset();
+
+    if (!pool.trim_timer)
+    {
+        pool.trim_timer = std::make_unique<wf::wl_timer<true>>();
+    }
+
+    if (!pool.trim_timer->is_connected())
+    {
+        pool.trim_timer->set_timeout(POOL_MAX_IDLE_TIME, [&pool] ()
+        {
+            render_begin();
+            trim_framebuffer_pool(wf::get_current_time() - POOL_MAX_IDLE_TIME);
+            render_end();
+            return !pool.free.empty();
+        });
+    }
+}
+
+framebuffer_pool_stats_t get_framebuffer_pool_stats()
+{
+    return framebuffer_pool.stats;
+}
+
 void fini()
 {
     render_begin();
     program.free_resources();
     color_program.free_resources();
+    trim_framebuffer_pool(std::numeric_limits<int64_t>::max());
+    framebuffer_pool.trim_timer.reset();
     render_end();
 }
 
@@ -134,6 +260,17 @@ namespace
 {
 wf::output_t *current_output = NULL;
 uint32_t current_output_fb   = 0;
+GLint forced_mag_filter = 0;
+}
+
+void set_texture_mag_filter(GLint filter)
+{
+    forced_mag_filter = filter;
+}
+
+GLint get_texture_mag_filter()
+{
+    return forced_mag_filter;
 }
 
 void bind_output(wf::output_t *output, uint32_t fb)
@@ -811,6 +948,8 @@ void program_t::set_active_texture(const wf::texture_t& texture)
     GL_CALL(glActiveTexture(GL_TEXTURE0));
     GL_CALL(glBindTexture(texture.target, texture.tex_id));
     GL_CALL(glTexParameteri(texture.target, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+    GL_CALL(glTexParameteri(texture.target, GL_TEXTURE_MAG_FILTER,
+        OpenGL::get_texture_mag_filter() ?: GL_LINEAR));
 
     glm::vec2 base{0.0f, 0.0f};
     glm::vec2 scale{1.0f, 1.0f};
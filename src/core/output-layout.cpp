@@ -1018,7 +1018,10 @@ class output_layout_t::impl
 
     wf::signal::connection_t<wf::reload_config_signal> on_config_reload = [=] (wf::reload_config_signal *ev)
     {
-        reconfigure_from_config();
+        if (ev->section_changed("output"))
+        {
+            reconfigure_from_config();
+        }
     };
 
     wf::signal::connection_t<core_backend_started_signal> on_backend_started =
@@ -4,6 +4,7 @@
 #include <wayfire/view.hpp>
 #include <wayfire/output.hpp>
 #include <algorithm>
+#include <unordered_map>
 
 #include "scene-priv.hpp"
 #include "wayfire/geometry.hpp"
@@ -13,6 +14,7 @@
 #include "wayfire/scene-render.hpp"
 #include "wayfire/signal-provider.hpp"
 #include <wayfire/core.hpp>
+#include <wayfire/unstable/translation-node.hpp>
 
 namespace wf
 {
@@ -45,9 +47,14 @@ namespace scene
 node_t::~node_t()
 {}
 
+// Instance generations are unique across all nodes, so that a node allocated at the same address as an
+// already destroyed node never has the same generation.
+static uint64_t last_instances_generation = 0;
+
 node_t::node_t(bool is_structure)
 {
     this->_is_structure = is_structure;
+    this->instances_generation = ++last_instances_generation;
 }
 
 void node_t::set_enabled(bool is_active)
@@ -326,30 +333,48 @@ std::optional<input_node_t> output_node_t::find_node_at(const wf::pointf_t& at)
     return node_t::find_node_at(at);
 }
 
+uint32_t output_node_t::optimize_update(uint32_t flags)
+{
+    return optimize_nested_render_instances(shared_from_this(), flags);
+}
+
 class output_render_instance_t : public default_render_instance_t
 {
     wf::output_t *output;
+    wf::output_t *shown_on;
     output_node_t *self;
+    damage_callback push_damage_child;
     std::vector<render_instance_uptr> children;
+    std::vector<child_instances_t> children_info;
+
+    wf::signal::connection_t<node_regen_instances_signal> on_regen_instances =
+        [=] (node_regen_instances_signal *ev)
+    {
+        regen_instances();
+        ev->handled = true;
+    };
 
   public:
     output_render_instance_t(output_node_t *self, damage_callback callback,
         wf::output_t *output, wf::output_t *shown_on) :
         default_render_instance_t(self, transform_damage(callback))
     {
-        this->self   = self;
-        this->output = output;
+        this->self     = self;
+        this->output   = output;
+        this->shown_on = shown_on;
+        this->push_damage_child = transform_damage(callback);
 
+        self->connect(&on_regen_instances);
+        regen_instances();
+    }
+
+    void regen_instances()
+    {
         // Children are stored as a sublist, because we need to translate every
-        // time between global and output-local geometry.
-        for (auto& child : self->get_children())
-        {
-            if (child->is_enabled())
-            {
-                child->gen_render_instances(children,
-                    transform_damage(callback), shown_on);
-            }
-        }
+        // time between global and output-local geometry. This also allows us to
+        // regenerate only the instances of this output's subtree when its
+        // children change.
+        regen_children_instances(self, children, children_info, push_damage_child, shown_on);
     }
 
     damage_callback transform_damage(damage_callback child_damage)
@@ -451,6 +476,24 @@ wf::geometry_t output_node_t::get_bounding_box()
 }
 
 // ------------------------------ root_node_t ----------------------------------
+/**
+ * Layer nodes keep the instances of their output nodes in a separate list, so that enabling or disabling an
+ * output node (or adding one) does not require regenerating the instances of the whole scenegraph.
+ * Render instances which collect the output nodes by themselves (like workspace streams) have to listen for
+ * node_regen_instances_signal on the layer nodes instead.
+ */
+class layer_node_t : public translation_node_t
+{
+  public:
+    layer_node_t() : translation_node_t(true)
+    {}
+
+    std::string stringify() const override
+    {
+        return node_t::stringify();
+    }
+};
+
 root_node_t::root_node_t() : floating_inner_node_t(true)
 {
     std::vector<node_ptr> children;
@@ -458,7 +501,7 @@ root_node_t::root_node_t() : floating_inner_node_t(true)
     this->priv = std::make_unique<root_node_t::priv_t>();
     for (int i = (int)layer::ALL_LAYERS - 1; i >= 0; i--)
     {
-        layers[i] = std::make_shared<floating_inner_node_t>(true);
+        layers[i] = std::make_shared<layer_node_t>();
         children.push_back(layers[i]);
     }
 
@@ -506,6 +549,24 @@ void update(node_ptr changed_node, uint32_t flags)
         flags |= update_flag::MASKED;
     }
 
+    if ((flags & update_flag::CHILDREN_LIST) && (changed_node != wf::get_core().scene()))
+    {
+        // Nodes whose render instances keep a separate list of children can update it locally, in which case
+        // the render instances of the parent nodes can be kept as they are.
+        node_regen_instances_signal data;
+        changed_node->emit(&data);
+        if (data.handled)
+        {
+            flags &= ~update_flag::CHILDREN_LIST;
+            flags |= update_flag::GEOMETRY;
+        }
+    }
+
+    if (flags & (update_flag::CHILDREN_LIST | update_flag::ENABLED))
+    {
+        changed_node->instances_generation = ++last_instances_generation;
+    }
+
     if (changed_node == wf::get_core().scene())
     {
         root_node_update_signal data;
@@ -534,6 +595,58 @@ floating_inner_node_t::~floating_inner_node_t()
     }
 }
 
+void regen_children_instances(node_t *node, std::vector<render_instance_uptr>& instances,
+    std::vector<child_instances_t>& children_info, damage_callback push_damage, wf::output_t *shown_on)
+{
+    struct previous_instances_t
+    {
+        size_t start;
+        uint64_t generation;
+        size_t count;
+    };
+
+    std::unordered_map<node_t*, previous_instances_t> previous;
+    size_t start = 0;
+    for (auto& info : children_info)
+    {
+        previous[info.node] = {start, info.generation, info.count};
+        start += info.count;
+    }
+
+    if (start != instances.size())
+    {
+        // Should not happen, but in case it does, regenerate everything.
+        previous.clear();
+    }
+
+    auto old_instances = std::move(instances);
+    instances.clear();
+    children_info.clear();
+
+    for (auto& ch : node->get_children())
+    {
+        if (!ch->is_enabled())
+        {
+            continue;
+        }
+
+        const size_t first = instances.size();
+        auto it = previous.find(ch.get());
+        if ((it != previous.end()) && (it->second.generation == ch->get_instances_generation()))
+        {
+            for (size_t i = 0; i < it->second.count; i++)
+            {
+                instances.push_back(std::move(old_instances[it->second.start + i]));
+            }
+        } else
+        {
+            ch->gen_render_instances(instances, push_damage, shown_on);
+        }
+
+        children_info.push_back({ch.get(), ch->get_instances_generation(), instances.size() - first});
+    }
+}
+
 uint32_t optimize_nested_render_instances(wf::scene::node_ptr node, uint32_t flags)
 {
     if (flags & (update_flag::CHILDREN_LIST | update_flag::ENABLED))
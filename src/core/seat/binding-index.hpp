@@ -0,0 +1,177 @@
+#pragma once
+
+#include <algorithm>
+#include <unordered_map>
+#include <wayfire/bindings.hpp>
+#include <wayfire/config/option-wrapper.hpp>
+#include "hotspot-manager.hpp"
+
+namespace wf
+{
+/**
+ * An index of the registered key, button and axis bindings (including the keys and buttons of activator
+ * bindings), keyed by (modifiers, keycode/button).
+ *
+ * The index does not track changes by itself. Whenever a binding is added or removed, or the value of one of
+ * the options changes, invalidate() has to be called, and the index is rebuilt on the next lookup.
+ */
+class binding_index_t
+{
+  public:
+    using key_binding_t = binding_t<wf::keybinding_t, key_callback>;
+    using axis_binding_t = binding_t<wf::keybinding_t, axis_callback>;
+    using button_binding_t = binding_t<wf::buttonbinding_t, button_callback>;
+    using activator_binding_t = binding_t<wf::activatorbinding_t, activator_callback>;
+
+    /**
+     * All bindings which match a given combination, in the order they were registered.
+     */
+    template<class Binding>
+    struct bucket_t
+    {
+        std::vector<Binding*> bindings;
+        std::vector<activator_binding_t*> activators;
+    };
+
+    binding_index_t(const binding_container_t<wf::keybinding_t, key_callback>& keys,
+        const binding_container_t<wf::keybinding_t, axis_callback>& axes,
+        const binding_container_t<wf::buttonbinding_t, button_callback>& buttons,
+        const binding_container_t<wf::activatorbinding_t, activator_callback>& activators) :
+        keys(keys), axes(axes), buttons(buttons), activators(activators)
+    {}
+
+    void invalidate()
+    {
+        dirty = true;
+    }
+
+    /** Find the key bindings and activators matching the given key combination. */
+    const bucket_t<key_binding_t>& find_key(const wf::keybinding_t& key)
+    {
+        return find(key_index, key.get_modifiers(), key.get_key());
+    }
+
+    /** Find the button bindings and activators matching the given button combination. */
+    const bucket_t<button_binding_t>& find_button(const wf::buttonbinding_t& button)
+    {
+        return find(button_index, button.get_modifiers(), button.get_button());
+    }
+
+    /** Find the axis bindings for the given modifiers. */
+    const bucket_t<axis_binding_t>& find_axis(uint32_t modifiers)
+    {
+        return find(axis_index, modifiers, 0);
+    }
+
+  private:
+    const binding_container_t<wf::keybinding_t, key_callback>& keys;
+    const binding_container_t<wf::keybinding_t, axis_callback>& axes;
+    const binding_container_t<wf::buttonbinding_t, button_callback>& buttons;
+    const binding_container_t<wf::activatorbinding_t, activator_callback>& activators;
+
+    template<class Binding>
+    using index_t = std::unordered_map<uint64_t, bucket_t<Binding>>;
+
+    index_t<key_binding_t> key_index;
+    index_t<axis_binding_t> axis_index;
+    index_t<button_binding_t> button_index;
+    bool dirty = true;
+
+    static uint64_t make_key(uint32_t modifiers, uint32_t code)
+    {
+        return ((uint64_t)modifiers << 32) | code;
+    }
+
+    template<class Binding>
+    const bucket_t<Binding>& find(index_t<Binding>& index, uint32_t modifiers, uint32_t code)
+    {
+        static const bucket_t<Binding> empty;
+        if (dirty)
+        {
+            rebuild();
+        }
+
+        auto it = index.find(make_key(modifiers, code));
+        return (it == index.end()) ? empty : it->second;
+    }
+
+    template<class Binding>
+    static void add_activator(index_t<Binding>& index, uint64_t key, activator_binding_t *binding)
+    {
+        auto& list = index[key].activators;
+        // The same combination may be listed more than once in an activator, but has_match() triggers the
+        // activator only once.
+        if (list.empty() || (list.back() != binding))
+        {
+            list.push_back(binding);
+        }
+    }
+
+    void rebuild()
+    {
+        key_index.clear();
+        axis_index.clear();
+        button_index.clear();
+
+        for (auto& binding : keys)
+        {
+            auto value = binding->activated_by->get_value();
+            key_index[make_key(value.get_modifiers(), value.get_key())].bindings.push_back(binding.get());
+        }
+
+        for (auto& binding : axes)
+        {
+            auto value = binding->activated_by->get_value();
+            // Axis bindings only match when the binding has no key.
+            if (value.get_key() == 0)
+            {
+                axis_index[make_key(value.get_modifiers(), 0)].bindings.push_back(binding.get());
+            }
+        }
+
+        for (auto& binding : buttons)
+        {
+            auto value = binding->activated_by->get_value();
+            button_index[make_key(value.get_modifiers(), value.get_button())].bindings.push_back(
+                binding.get());
+        }
+
+        // activatorbinding_t does not expose its key and button lists, so we split its string representation
+        // the same way wf-config parses it: each part is tried as a keybinding first, then as a button.
+        for (auto& binding : activators)
+        {
+            const std::string value = binding->activated_by->get_value_str();
+            size_t start = 0;
+            while (start <= value.size())
+            {
+                size_t end = std::min(value.find('|', start), value.size());
+                std::string part = trim(value.substr(start, end - start));
+                start = end + 1;
+
+                if (auto key = wf::option_type::from_string<wf::keybinding_t>(part))
+                {
+                    add_activator(key_index, make_key(key->get_modifiers(), key->get_key()), binding.get());
+                } else if (auto button = wf::option_type::from_string<wf::buttonbinding_t>(part))
+                {
+                    add_activator(button_index, make_key(button->get_modifiers(), button->get_button()),
+                        binding.get());
+                }
+            }
+        }
+
+        dirty = false;
+    }
+
+    static std::string trim(const std::string& str)
+    {
+        const char *ws = " \t\n";
+        size_t first   = str.find_first_not_of(ws);
+        if (first == std::string::npos)
+        {
+            return "";
+        }
+
+        return str.substr(first, str.find_last_not_of(ws) - first + 1);
+    }
+};
+}
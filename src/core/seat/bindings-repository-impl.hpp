@@ -2,6 +2,7 @@
 
 #include "wayfire/bindings-repository.hpp"
 #include "hotspot-manager.hpp"
+#include "binding-index.hpp"
 #include "wayfire/signal-definitions.hpp"
 #include <wayfire/debug.hpp>
 
@@ -28,15 +29,57 @@ struct wf::bindings_repository_t::impl
 
     void reparse_extensions();
 
+    /**
+     * Start or stop watching the given option for changes, so that the index can be invalidated.
+     * Options may be shared by several bindings, so watches are reference-counted.
+     */
+    void watch_option(std::shared_ptr<wf::config::option_base_t> option)
+    {
+        if (watched_options[option.get()]++ == 0)
+        {
+            option->add_updated_handler(&on_binding_option_changed);
+        }
+
+        index.invalidate();
+    }
+
+    void unwatch_option(std::shared_ptr<wf::config::option_base_t> option)
+    {
+        auto it = watched_options.find(option.get());
+        if ((it != watched_options.end()) && (--it->second == 0))
+        {
+            option->rem_updated_handler(&on_binding_option_changed);
+            watched_options.erase(it);
+        }
+
+        index.invalidate();
+    }
+
+    ~impl()
+    {
+        for (auto& [option, _] : watched_options)
+        {
+            option->rem_updated_handler(&on_binding_option_changed);
+        }
+    }
+
     binding_container_t<wf::keybinding_t, key_callback> keys;
     binding_container_t<wf::keybinding_t, axis_callback> axes;
     binding_container_t<wf::buttonbinding_t, button_callback> buttons;
     binding_container_t<wf::activatorbinding_t, activator_callback> activators;
 
+    binding_index_t index{keys, axes, buttons, activators};
+    std::unordered_map<wf::config::option_base_t*, int> watched_options;
+    wf::config::option_base_t::updated_callback_t on_binding_option_changed = [=] ()
+    {
+        index.invalidate();
+    };
+
     hotspot_manager_t hotspot_mgr;
 
     wf::signal::connection_t<wf::reload_config_signal> on_config_reload = [=] (wf::reload_config_signal *ev)
     {
+        index.invalidate();
         recreate_hotspots();
         reparse_extensions();
     };
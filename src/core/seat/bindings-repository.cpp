@@ -9,13 +9,14 @@ wf::bindings_repository_t::bindings_repository_t()
 }
 
 template<class Option, class Callback>
-static void push_binding(wf::binding_container_t<Option, Callback>& bindings,
-    wf::option_sptr_t<Option> opt, Callback *callback)
+static void push_binding(wf::bindings_repository_t::impl *priv,
+    wf::binding_container_t<Option, Callback>& bindings, wf::option_sptr_t<Option> opt, Callback *callback)
 {
     auto bnd = std::make_unique<wf::binding_t<Option, Callback>>();
     bnd->activated_by = opt;
     bnd->callback     = callback;
     bindings.emplace_back(std::move(bnd));
+    priv->watch_option(opt);
 }
 
 wf::bindings_repository_t::~bindings_repository_t()
@@ -23,29 +24,54 @@ wf::bindings_repository_t::~bindings_repository_t()
 
 void wf::bindings_repository_t::add_key(option_sptr_t<keybinding_t> key, wf::key_callback *cb)
 {
-    push_binding(priv->keys, key, cb);
+    push_binding(priv.get(), priv->keys, key, cb);
 }
 
 void wf::bindings_repository_t::add_axis(option_sptr_t<keybinding_t> axis, wf::axis_callback *cb)
 {
-    push_binding(priv->axes, axis, cb);
+    push_binding(priv.get(), priv->axes, axis, cb);
 }
 
 void wf::bindings_repository_t::add_button(option_sptr_t<buttonbinding_t> button, wf::button_callback *cb)
 {
-    push_binding(priv->buttons, button, cb);
+    push_binding(priv.get(), priv->buttons, button, cb);
 }
 
 void wf::bindings_repository_t::add_activator(
     option_sptr_t<activatorbinding_t> activator, wf::activator_callback *cb)
 {
-    push_binding(priv->activators, activator, cb);
+    push_binding(priv.get(), priv->activators, activator, cb);
     if (activator->get_value().get_hotspots().size())
     {
         priv->recreate_hotspots();
     }
 }
 
+/**
+ * Collect the callbacks of all bindings in the bucket before calling any of them.
+ * We must be careful because a callback might erase bindings (and thus invalidate the index), so we copy the
+ * callback pointers first.
+ */
+template<class Bucket>
+static auto collect_callbacks(const Bucket& bucket)
+{
+    using callback_t = std::remove_pointer_t<decltype(bucket.bindings[0]->callback)>;
+    std::pair<std::vector<callback_t*>, std::vector<wf::activator_callback*>> callbacks;
+    callbacks.first.reserve(bucket.bindings.size());
+    callbacks.second.reserve(bucket.activators.size());
+    for (auto& binding : bucket.bindings)
+    {
+        callbacks.first.push_back(binding->callback);
+    }
+
+    for (auto& binding : bucket.activators)
+    {
+        callbacks.second.push_back(binding->callback);
+    }
+
+    return callbacks;
+}
+
 bool wf::bindings_repository_t::handle_key(const wf::keybinding_t& pressed,
     uint32_t mod_binding_key)
 {
@@ -54,50 +80,28 @@ bool wf::bindings_repository_t::handle_key(const wf::keybinding_t& pressed,
         return false;
     }
 
-    std::vector<std::function<bool()>> callbacks;
-    for (auto& binding : this->priv->keys)
+    auto [keys, activators] = collect_callbacks(priv->index.find_key(pressed));
+
+    wf::activator_data_t ev = {
+        .source = activator_source_t::KEYBINDING,
+        .activation_data = pressed.get_key()
+    };
+
+    if (mod_binding_key)
     {
-        if (binding->activated_by->get_value() == pressed)
-        {
-            /* We must be careful because the callback might be erased,
-             * so force copy the callback into the lambda */
-            auto callback = binding->callback;
-            callbacks.emplace_back([pressed, callback] ()
-            {
-                return (*callback)(pressed);
-            });
-        }
+        ev.source = activator_source_t::MODIFIERBINDING;
+        ev.activation_data = mod_binding_key;
     }
 
-    for (auto& binding : this->priv->activators)
+    bool handled = false;
+    for (auto& cb : keys)
     {
-        if (binding->activated_by->get_value().has_match(pressed))
-        {
-            /* We must be careful because the callback might be erased,
-             * so force copy the callback into the lambda */
-            auto callback = binding->callback;
-            callbacks.emplace_back([pressed, callback, mod_binding_key] ()
-            {
-                wf::activator_data_t ev = {
-                    .source = activator_source_t::KEYBINDING,
-                    .activation_data = pressed.get_key()
-                };
-
-                if (mod_binding_key)
-                {
-                    ev.source = activator_source_t::MODIFIERBINDING;
-                    ev.activation_data = mod_binding_key;
-                }
-
-                return (*callback)(ev);
-            });
-        }
+        handled |= (*cb)(pressed);
     }
 
-    bool handled = false;
-    for (auto& cb : callbacks)
+    for (auto& cb : activators)
     {
-        handled |= cb();
+        handled |= (*cb)(ev);
     }
 
     return handled;
@@ -111,16 +115,7 @@ bool wf::bindings_repository_t::handle_axis(uint32_t modifiers,
         return false;
     }
 
-    std::vector<wf::axis_callback*> callbacks;
-
-    for (auto& binding : this->priv->axes)
-    {
-        if (binding->activated_by->get_value() == wf::keybinding_t{modifiers, 0})
-        {
-            callbacks.push_back(binding->callback);
-        }
-    }
-
+    auto [callbacks, _] = collect_callbacks(priv->index.find_axis(modifiers));
     for (auto call : callbacks)
     {
         (*call)(ev);
@@ -136,43 +131,22 @@ bool wf::bindings_repository_t::handle_button(const wf::buttonbinding_t& pressed
         return false;
     }
 
-    std::vector<std::function<bool()>> callbacks;
-    for (auto& binding : this->priv->buttons)
-    {
-        if (binding->activated_by->get_value() == pressed)
-        {
-            /* We must be careful because the callback might be erased,
-             * so force copy the callback into the lambda */
-            auto callback = binding->callback;
-            callbacks.emplace_back([=] ()
-            {
-                return (*callback)(pressed);
-            });
-        }
-    }
+    auto [buttons, activators] = collect_callbacks(priv->index.find_button(pressed));
 
-    for (auto& binding : this->priv->activators)
+    wf::activator_data_t data = {
+        .source = activator_source_t::BUTTONBINDING,
+        .activation_data = pressed.get_button(),
+    };
+
+    bool binding_handled = false;
+    for (auto call : buttons)
     {
-        if (binding->activated_by->get_value().has_match(pressed))
-        {
-            /* We must be careful because the callback might be erased,
-             * so force copy the callback into the lambda */
-            auto callback = binding->callback;
-            callbacks.emplace_back([=] ()
-            {
-                wf::activator_data_t data = {
-                    .source = activator_source_t::BUTTONBINDING,
-                    .activation_data = pressed.get_button(),
-                };
-                return (*callback)(data);
-            });
-        }
+        binding_handled |= (*call)(pressed);
     }
 
-    bool binding_handled = false;
-    for (auto call : callbacks)
+    for (auto call : activators)
     {
-        binding_handled |= call();
+        binding_handled |= (*call)(data);
     }
 
     return binding_handled;
@@ -242,8 +216,16 @@ bool wf::bindings_repository_t::handle_extension_generic(
 
 void wf::bindings_repository_t::rem_binding(void *callback)
 {
-    const auto& erase = [callback] (auto& container)
+    const auto& erase = [callback, this] (auto& container)
     {
+        for (auto& binding : container)
+        {
+            if (binding->callback == callback)
+            {
+                priv->unwatch_option(binding->activated_by);
+            }
+        }
+
         auto it = std::remove_if(container.begin(), container.end(),
             [callback] (const auto& ptr)
         {
@@ -2,29 +2,10 @@
 #include "wayfire/core.hpp"
 #include <wayfire/output-layout.hpp>
 #include <wayfire/touch/touch.hpp>
+#include <algorithm>
 
-void wf::hotspot_instance_t::process_input_motion(wf::pointf_t gc)
+void wf::hotspot_instance_t::process_motion_inside()
 {
-    const auto& reset_hotspot = [&] ()
-    {
-        timer.disconnect();
-        this->armed = true;
-    };
-
-    auto target = wf::get_core().output_layout->get_output_coords_at(gc, gc);
-    if (target != last_output)
-    {
-        reset_hotspot();
-        last_output = target;
-        recalc_geometry();
-    }
-
-    if (!(hotspot_geometry[0] & gc) && !(hotspot_geometry[1] & gc))
-    {
-        reset_hotspot();
-        return;
-    }
-
     if (!timer.is_connected() && this->armed)
     {
         this->armed = false;
@@ -36,15 +17,14 @@ void wf::hotspot_instance_t::process_input_motion(wf::pointf_t gc)
     }
 }
 
-wf::geometry_t wf::hotspot_instance_t::pin(wf::dimensions_t dim) noexcept
+void wf::hotspot_instance_t::reset()
 {
-    if (!last_output)
-    {
-        return {0, 0, 0, 0};
-    }
-
-    auto og = last_output->get_layout_geometry();
+    timer.disconnect();
+    this->armed = true;
+}
 
+wf::geometry_t wf::hotspot_instance_t::pin(wf::geometry_t og, wf::dimensions_t dim) const noexcept
+{
     wf::geometry_t result;
     result.width  = dim.width;
     result.height = dim.height;
@@ -75,46 +55,41 @@ wf::geometry_t wf::hotspot_instance_t::pin(wf::dimensions_t dim) noexcept
     return wf::clamp(result, og);
 }
 
-void wf::hotspot_instance_t::recalc_geometry() noexcept
+std::array<wf::geometry_t, 2> wf::hotspot_instance_t::calculate_geometry(
+    wf::geometry_t output_geometry) const noexcept
 {
     uint32_t cnt_edges = __builtin_popcount(edges);
 
     if (cnt_edges == 2)
     {
-        hotspot_geometry[0] = pin({away, along});
-        hotspot_geometry[1] = pin({along, away});
+        return {pin(output_geometry, {away, along}), pin(output_geometry, {along, away})};
+    }
+
+    wf::dimensions_t dim;
+    if (edges & (OUTPUT_EDGE_LEFT | OUTPUT_EDGE_RIGHT))
+    {
+        dim = {away, along};
     } else
     {
-        wf::dimensions_t dim;
-        if (edges & (OUTPUT_EDGE_LEFT | OUTPUT_EDGE_RIGHT))
-        {
-            dim = {away, along};
-        } else
-        {
-            dim = {along, away};
-        }
-
-        hotspot_geometry[0] = pin(dim);
-        hotspot_geometry[1] = hotspot_geometry[0];
+        dim = {along, away};
     }
+
+    auto geometry = pin(output_geometry, dim);
+    return {geometry, geometry};
 }
 
 wf::hotspot_instance_t::hotspot_instance_t(uint32_t edges, uint32_t along, uint32_t away, int32_t timeout,
     std::function<void(uint32_t)> callback)
 {
-    wf::get_core().connect(&on_motion_event);
-    wf::get_core().connect(&on_motion_event);
-    wf::get_core().connect(&on_touch_motion);
-
     this->edges = edges;
     this->along = along;
     this->away  = away;
     this->timeout_ms = timeout;
     this->callback   = callback;
+}
 
-    recalc_geometry();
-
-    // callbacks
+wf::hotspot_manager_t::hotspot_manager_t()
+{
     on_tablet_axis = [=] (wf::post_input_event_signal<wlr_tablet_tool_axis_event> *ev)
     {
         process_input_motion(wf::get_core().get_cursor_position());
@@ -133,10 +108,103 @@ wf::hotspot_instance_t::hotspot_instance_t(uint32_t edges, uint32_t along, uint3
             process_input_motion(wf::get_core().get_touch_position(0));
         }
     };
+
+    wf::get_core().connect(&on_tablet_axis);
+    wf::get_core().connect(&on_motion_event);
+    wf::get_core().connect(&on_touch_motion);
+}
+
+void wf::hotspot_manager_t::reset_active()
+{
+    for (auto& instance : active)
+    {
+        instance->reset();
+    }
+
+    active.clear();
+}
+
+void wf::hotspot_manager_t::rebuild_index(wf::output_t *output)
+{
+    index.output = output;
+    index.output_geometry = output ? output->get_layout_geometry() : wf::geometry_t{0, 0, 0, 0};
+    index.hot_region.clear();
+    index.rects.clear();
+    index_dirty = false;
+
+    if (!output)
+    {
+        return;
+    }
+
+    for (auto& instance : hotspots)
+    {
+        auto geometry = instance->calculate_geometry(index.output_geometry);
+        index.rects.push_back({geometry[0], instance.get()});
+        index.hot_region |= geometry[0];
+        if (geometry[1] != geometry[0])
+        {
+            index.rects.push_back({geometry[1], instance.get()});
+            index.hot_region |= geometry[1];
+        }
+    }
+}
+
+void wf::hotspot_manager_t::process_input_motion(wf::pointf_t gc)
+{
+    if (hotspots.empty())
+    {
+        return;
+    }
+
+    auto target = wf::get_core().output_layout->get_output_coords_at(gc, gc);
+    if (index_dirty || (target != index.output) ||
+        (target && (target->get_layout_geometry() != index.output_geometry)))
+    {
+        reset_active();
+        rebuild_index(target);
+    }
+
+    if (!index.hot_region.contains_pointf(gc))
+    {
+        reset_active();
+        return;
+    }
+
+    const auto& contains = [] (const std::vector<hotspot_instance_t*>& list, hotspot_instance_t *instance)
+    {
+        return std::find(list.begin(), list.end(), instance) != list.end();
+    };
+
+    std::vector<hotspot_instance_t*> now_active;
+    for (auto& [geometry, instance] : index.rects)
+    {
+        if ((geometry & gc) && !contains(now_active, instance))
+        {
+            now_active.push_back(instance);
+        }
+    }
+
+    for (auto& instance : active)
+    {
+        if (!contains(now_active, instance))
+        {
+            instance->reset();
+        }
+    }
+
+    for (auto& instance : now_active)
+    {
+        instance->process_motion_inside();
+    }
+
+    active = std::move(now_active);
 }
 
 void wf::hotspot_manager_t::update_hotspots(const container_t& activators)
 {
+    active.clear();
+    index_dirty = true;
     hotspots.clear();
     for (const auto& opt : activators)
     {
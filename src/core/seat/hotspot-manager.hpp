@@ -1,10 +1,12 @@
 #pragma once
 
 #include <any>
+#include <array>
 #include "wayfire/util.hpp"
 #include <wayfire/config/types.hpp>
 #include <wayfire/output.hpp>
 #include <wayfire/util/log.hpp>
+#include <wayfire/region.hpp>
 #include <wayfire/signal-definitions.hpp>
 #include <wayfire/nonstd/wlroots-full.hpp>
 #include <any>
@@ -27,6 +29,9 @@ template<class Option, class Callback> using binding_container_t =
 
 /**
  * Represents an instance of a hotspot.
+ *
+ * The instance itself does not listen for input events, the hotspot_manager_t tells it when the cursor enters
+ * or leaves its area.
  */
 class hotspot_instance_t
 {
@@ -35,11 +40,19 @@ class hotspot_instance_t
     hotspot_instance_t(uint32_t edges, uint32_t along, uint32_t away, int32_t timeout,
         std::function<void(uint32_t)> callback);
 
-  private:
-    /** The possible hotspot rectangles */
-    wf::geometry_t hotspot_geometry[2];
-    wf::output_t *last_output = nullptr;
+    /**
+     * Calculate the hotspot rectangles on an output with the given layout geometry.
+     * Hotspots on a single edge have two identical rectangles.
+     */
+    std::array<wf::geometry_t, 2> calculate_geometry(wf::geometry_t output_geometry) const noexcept;
+
+    /** The input position moved inside the hotspot. */
+    void process_motion_inside();
 
+    /** The input position left the hotspot, or the hotspots were recalculated. */
+    void reset();
+
+  private:
     /** Requested dimensions */
     int32_t along, away;
 
@@ -61,34 +74,54 @@ class hotspot_instance_t
     /** Callback to execute */
     std::function<void(uint32_t)> callback;
 
-    wf::signal::connection_t<wf::post_input_event_signal<wlr_tablet_tool_axis_event>> on_tablet_axis;
-    wf::signal::connection_t<wf::post_input_event_signal<wlr_pointer_motion_event>> on_motion_event;
-    wf::signal::connection_t<wf::post_input_event_signal<wlr_touch_motion_event>> on_touch_motion;
-
-    /** Update state based on input motion */
-    void process_input_motion(wf::pointf_t gc);
-
     /** Calculate a rectangle with size @dim inside @og at the correct edges. */
-    wf::geometry_t pin(wf::dimensions_t dim) noexcept;
-
-    /** Recalculate the hotspot geometries. */
-    void recalc_geometry() noexcept;
+    wf::geometry_t pin(wf::geometry_t og, wf::dimensions_t dim) const noexcept;
 };
 
 /**
  * Manages hotspot bindings on the given output.
  * A part of the bindings_repository_t.
+ *
+ * The manager listens for input motion once for all hotspots. The rectangles of all hotspots on the output
+ * with the input are kept in an index, so that an event outside of all hotspots (the common case) costs a
+ * single region lookup, regardless of the number of hotspots.
  */
 class hotspot_manager_t
 {
   public:
-    hotspot_manager_t()
-    {}
+    hotspot_manager_t();
 
     using container_t = binding_container_t<activatorbinding_t, activator_callback>;
     void update_hotspots(const container_t& activators);
 
   private:
     std::vector<std::unique_ptr<hotspot_instance_t>> hotspots;
+
+    /** The hotspot rectangles on one output, in output-layout coordinates. */
+    struct output_index_t
+    {
+        wf::output_t *output = nullptr;
+        wf::geometry_t output_geometry = {0, 0, 0, 0};
+        /** The union of all rectangles, for quickly rejecting positions outside of all hotspots. */
+        wf::region_t hot_region;
+        std::vector<std::pair<wf::geometry_t, hotspot_instance_t*>> rects;
+    };
+
+    /** The index of the output which last had input, rebuilt when the input moves to another output. */
+    output_index_t index;
+    bool index_dirty = true;
+
+    /** Hotspots which contained the last input position. */
+    std::vector<hotspot_instance_t*> active;
+
+    void rebuild_index(wf::output_t *output);
+    void reset_active();
+
+    wf::signal::connection_t<wf::post_input_event_signal<wlr_tablet_tool_axis_event>> on_tablet_axis;
+    wf::signal::connection_t<wf::post_input_event_signal<wlr_pointer_motion_event>> on_motion_event;
+    wf::signal::connection_t<wf::post_input_event_signal<wlr_touch_motion_event>> on_touch_motion;
+
+    /** Update state based on input motion */
+    void process_input_motion(wf::pointf_t gc);
 };
 }
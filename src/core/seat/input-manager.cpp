@@ -159,8 +159,14 @@ wf::input_manager_t::input_manager_t()
     });
     input_device_created.connect(&wf::get_core().backend->events.new_input);
 
-    config_updated = [=] (auto)
+    config_updated = [=] (wf::reload_config_signal *ev)
     {
+        // Covers the input section and the per-device input:* and input-device:* sections
+        if (!ev->section_changed("input"))
+        {
+            return;
+        }
+
         for (auto& dev : input_devices)
         {
             dev->update_options();
@@ -1,20 +1,11 @@
 #include "wayfire/signal-provider.hpp"
 #include "wayfire/txn/transaction.hpp"
 #include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
 #include <wayfire/txn/transaction-manager.hpp>
 #include <wayfire/debug.hpp>
 
-static bool transactions_intersect(const wf::txn::transaction_uptr& a, const wf::txn::transaction_uptr& b)
-{
-    const auto& obj_a = a->get_objects();
-    const auto& obj_b = b->get_objects();
-
-    return std::any_of(obj_a.begin(), obj_a.end(), [&] (const wf::txn::transaction_object_sptr& x)
-    {
-        return std::find(obj_b.begin(), obj_b.end(), x) != obj_b.end();
-    });
-}
-
 struct wf::txn::transaction_manager_t::impl
 {
     impl()
@@ -26,48 +17,105 @@ struct wf::txn::transaction_manager_t::impl
     {
         LOGC(TXN, "Scheduling transaction ", tx.get());
 
-        // Step 1: add any objects which are directly or indirectly connected to the objects in tx
-        coalesce_transactions(tx);
+        // Step 1: find the pending transactions which share objects with tx
+        find_conflicts(tx);
+
+        // Step 2: merge tx and the conflicting transactions into one. At this point, there are no conflicts
+        // in all pending txs.
+        transaction_t *target = coalesce_transactions(tx);
+        if (target == tx.get())
+        {
+            for (auto& obj : tx->get_objects())
+            {
+                pending_objects[obj.get()] = tx.get();
+            }
 
-        // Step 2: remove any transactions we don't need anymore, as their objects were added to tx
-        remove_conflicts(tx);
+            pending.push_back(std::move(tx));
+        } else
+        {
+            LOGC(TXN, "Transaction ", tx.get(), " merged into ", target);
+        }
 
-        // Step 3: schedule tx for execution. At this point, there are no conflicts in all pending txs
-        pending.push_back(std::move(tx));
+        // Step 3: remove any transactions we don't need anymore, as their objects were added to the target
+        remove_conflicts();
         consider_commit();
     }
 
-    void coalesce_transactions(const transaction_uptr& tx)
+    void find_conflicts(const transaction_uptr& tx)
     {
-        while (true)
+        // Pending transactions never share objects, so the objects of the conflicting transactions cannot be
+        // part of any other pending transaction, and only the objects of tx need to be checked.
+        for (auto& obj : tx->get_objects())
         {
-            const size_t start_size = tx->get_objects().size();
-            for (auto& existing : pending)
+            auto it = pending_objects.find(obj.get());
+            if ((it != pending_objects.end()) && merged.insert(it->second).second)
             {
-                if (transactions_intersect(existing, tx))
+                merged_order.push_back(it->second);
+            }
+        }
+    }
+
+    /**
+     * Merge tx and the conflicting pending transactions into the largest of them, so that every object is
+     * copied to another transaction only a logarithmic number of times, even for long chains of
+     * overlapping transactions.
+     *
+     * @return The transaction which contains all objects afterwards.
+     */
+    transaction_t *coalesce_transactions(const transaction_uptr& tx)
+    {
+        transaction_t *target = tx.get();
+        for (auto& existing : merged_order)
+        {
+            if (existing->get_objects().size() >= target->get_objects().size())
+            {
+                target = existing;
+            }
+        }
+
+        auto absorb = [&] (transaction_t *source)
+        {
+            for (auto& obj : source->get_objects())
+            {
+                target->add_object(obj);
+                if (target != tx.get())
                 {
-                    for (auto& obj : existing->get_objects())
-                    {
-                        tx->add_object(obj);
-                    }
+                    pending_objects[obj.get()] = target;
                 }
             }
+        };
 
-            if (start_size == tx->get_objects().size())
+        for (auto& existing : merged_order)
+        {
+            if (existing != target)
             {
-                // No new objects were added in the last iteration => done
-                break;
+                absorb(existing);
             }
         }
+
+        if (target != tx.get())
+        {
+            absorb(tx.get());
+            merged.erase(target);
+        }
+
+        return target;
     }
 
-    void remove_conflicts(const transaction_uptr& tx)
+    void remove_conflicts()
     {
+        merged_order.clear();
+        if (merged.empty())
+        {
+            return;
+        }
+
         auto it = std::remove_if(pending.begin(), pending.end(), [&] (const transaction_uptr& existing)
         {
-            return transactions_intersect(existing, tx);
+            return merged.count(existing.get());
         });
         pending.erase(it, pending.end());
+        merged.clear();
     }
 
     // Try to commit as many transactions as possible
@@ -83,6 +131,11 @@ struct wf::txn::transaction_manager_t::impl
             {
                 auto tx = std::move(pending[idx]);
                 pending.erase(pending.begin() + idx);
+                for (auto& obj : tx->get_objects())
+                {
+                    pending_objects.erase(obj.get());
+                }
+
                 do_commit(std::move(tx));
                 // Note: the container may change after this operation, because some objects emit ready
                 // directly inside commit().
@@ -95,14 +148,19 @@ struct wf::txn::transaction_manager_t::impl
 
     bool can_commit_transaction(const transaction_uptr& tx)
     {
-        return std::none_of(committed.begin(), committed.end(), [&] (const transaction_uptr& comm)
+        return std::none_of(tx->get_objects().begin(), tx->get_objects().end(), [&] (const auto& obj)
         {
-            return transactions_intersect(tx, comm);
+            return committed_objects.count(obj.get());
         });
     }
 
     void do_commit(transaction_uptr tx)
     {
+        for (auto& obj : tx->get_objects())
+        {
+            committed_objects.insert(obj.get());
+        }
+
         tx->connect(&on_tx_apply);
         committed.push_back(std::move(tx));
         // Note: this might immediately trigger tx_apply if all objects are already ready!
@@ -114,6 +172,15 @@ struct wf::txn::transaction_manager_t::impl
     std::vector<transaction_uptr> pending;
     wf::wl_idle_call idle_clear_done;
 
+    // Indices of the objects in the pending and committed transactions. Transactions in each of the two
+    // lists never share objects, so conflicts can be found by looking up the objects of a transaction
+    // instead of comparing it to every other transaction.
+    std::unordered_map<transaction_object_t*, transaction_t*> pending_objects;
+    std::unordered_set<transaction_object_t*> committed_objects;
+    // Temporary storage for the pending transactions which conflict with a newly scheduled transaction.
+    std::unordered_set<transaction_t*> merged;
+    std::vector<transaction_t*> merged_order;
+
     wf::signal::connection_t<transaction_applied_signal> on_tx_apply = [&] (transaction_applied_signal *ev)
     {
         // Move transactions which are done from committed to done.
@@ -124,6 +191,10 @@ struct wf::txn::transaction_manager_t::impl
         });
 
         wf::dassert(it != committed.end(), "Transaction not found in committed list");
+        for (auto& obj : (*it)->get_objects())
+        {
+            committed_objects.erase(obj.get());
+        }
 
         done.push_back(std::move(*it));
         committed.erase(it);
@@ -37,8 +37,7 @@ const std::vector<wf::txn::transaction_object_sptr>& wf::txn::transaction_t::get
 
 void wf::txn::transaction_t::add_object(transaction_object_sptr object)
 {
-    auto it = std::find(objects.begin(), objects.end(), object);
-    if (it == objects.end())
+    if (object_set.insert(object.get()).second)
     {
         LOGC(TXNI, "Transaction ", this, " add object ", object->stringify());
         objects.push_back(object);
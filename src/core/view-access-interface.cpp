@@ -9,6 +9,7 @@
 #include <algorithm>
 #include <iostream>
 #include <string>
+#include <unordered_map>
 #include <wlr/util/edges.h>
 
 namespace wf
@@ -24,7 +25,24 @@ view_access_interface_t::~view_access_interface_t()
 
 variant_t view_access_interface_t::get(const std::string & identifier, bool & error)
 {
-    variant_t out = std::string(""); // Default to empty string as output.
+    static const std::unordered_map<std::string, property_t> properties = {
+        {"app_id", property_t::APP_ID},
+        {"title", property_t::TITLE},
+        {"role", property_t::ROLE},
+        {"fullscreen", property_t::FULLSCREEN},
+        {"activated", property_t::ACTIVATED},
+        {"minimized", property_t::MINIMIZED},
+        {"focusable", property_t::FOCUSABLE},
+        {"mapped", property_t::MAPPED},
+        {"tiled-left", property_t::TILED_LEFT},
+        {"tiled-right", property_t::TILED_RIGHT},
+        {"tiled-top", property_t::TILED_TOP},
+        {"tiled-bottom", property_t::TILED_BOTTOM},
+        {"maximized", property_t::MAXIMIZED},
+        {"floating", property_t::FLOATING},
+        {"type", property_t::TYPE},
+    };
+
     error = false; // Assume things will go well.
 
     // Cannot operate if no view is set.
@@ -32,17 +50,49 @@ variant_t view_access_interface_t::get(const std::string & identifier, bool & er
     {
         error = true;
 
-        return out;
+        return std::string("");
+    }
+
+    auto it = properties.find(identifier);
+    if (it == properties.end())
+    {
+        std::cerr << "View access interface: Get operation triggered to" <<
+            " unsupported view property " << identifier << std::endl;
+
+        return std::string("");
+    }
+
+    if (!_caching)
+    {
+        return get_property(it->second, error);
+    }
+
+    auto& cached = _cache[(size_t)it->second];
+    if (!cached.has_value())
+    {
+        auto value = get_property(it->second, error);
+        if (error)
+        {
+            return value;
+        }
+
+        cached = std::move(value);
     }
 
+    return cached.value();
+}
+
+variant_t view_access_interface_t::get_property(property_t property, bool & error)
+{
+    variant_t out = std::string(""); // Default to empty string as output.
     uint32_t view_tiled_edges = toplevel_cast(_view) ? toplevel_cast(_view)->pending_tiled_edges() : 0;
-    if (identifier == "app_id")
+    if (property == property_t::APP_ID)
     {
         out = _view->get_app_id();
-    } else if (identifier == "title")
+    } else if (property == property_t::TITLE)
     {
         out = _view->get_title();
-    } else if (identifier == "role")
+    } else if (property == property_t::ROLE)
     {
         switch (_view->role)
         {
@@ -65,40 +115,40 @@ variant_t view_access_interface_t::get(const std::string & identifier, bool & er
             error = true;
             break;
         }
-    } else if (identifier == "fullscreen")
+    } else if (property == property_t::FULLSCREEN)
     {
         out = toplevel_cast(_view) ? toplevel_cast(_view)->pending_fullscreen() : false;
-    } else if (identifier == "activated")
+    } else if (property == property_t::ACTIVATED)
     {
         out = toplevel_cast(_view) ? toplevel_cast(_view)->activated : false;
-    } else if (identifier == "minimized")
+    } else if (property == property_t::MINIMIZED)
     {
         out = toplevel_cast(_view) ? toplevel_cast(_view)->minimized : false;
-    } else if (identifier == "focusable")
+    } else if (property == property_t::FOCUSABLE)
     {
         out = _view->is_focusable();
-    } else if (identifier == "mapped")
+    } else if (property == property_t::MAPPED)
     {
         out = _view->is_mapped();
-    } else if (identifier == "tiled-left")
+    } else if (property == property_t::TILED_LEFT)
     {
         out = ((view_tiled_edges & WLR_EDGE_LEFT) > 0);
-    } else if (identifier == "tiled-right")
+    } else if (property == property_t::TILED_RIGHT)
     {
         out = ((view_tiled_edges & WLR_EDGE_RIGHT) > 0);
-    } else if (identifier == "tiled-top")
+    } else if (property == property_t::TILED_TOP)
     {
         out = ((view_tiled_edges & WLR_EDGE_TOP) > 0);
-    } else if (identifier == "tiled-bottom")
+    } else if (property == property_t::TILED_BOTTOM)
     {
         out = ((view_tiled_edges & WLR_EDGE_BOTTOM) > 0);
-    } else if (identifier == "maximized")
+    } else if (property == property_t::MAXIMIZED)
     {
         out = (view_tiled_edges == TILED_EDGES_ALL);
-    } else if (identifier == "floating")
+    } else if (property == property_t::FLOATING)
     {
         out = toplevel_cast(_view) ? (toplevel_cast(_view)->pending_tiled_edges() == 0) : false;
-    } else if (identifier == "type")
+    } else if (property == property_t::TYPE)
     {
         do {
             if (_view->role == VIEW_ROLE_TOPLEVEL)
@@ -144,10 +194,6 @@ variant_t view_access_interface_t::get(const std::string & identifier, bool & er
 
             out = std::string("unknown");
         } while (false);
-    } else
-    {
-        std::cerr << "View access interface: Get operation triggered to" <<
-            " unsupported view property " << identifier << std::endl;
     }
 
     return out;
@@ -156,5 +202,20 @@ variant_t view_access_interface_t::get(const std::string & identifier, bool & er
 void view_access_interface_t::set_view(wayfire_view view)
 {
     _view = view;
+    clear_cache();
+}
+
+void view_access_interface_t::set_caching(bool enabled)
+{
+    _caching = enabled;
+    clear_cache();
+}
+
+void view_access_interface_t::clear_cache()
+{
+    for (auto& value : _cache)
+    {
+        value.reset();
+    }
 }
 } // End namespace wf.
@@ -8,6 +8,7 @@
 #include <wayfire/core.hpp>
 
 #include <cstring>
+#include <map>
 #include <sys/inotify.h>
 #include <filesystem>
 #include <unistd.h>
@@ -30,6 +31,77 @@ static void reload_config(int fd)
     wf::config::load_configuration_options_from_file(*cfg_manager, config_file);
 }
 
+/**
+ * The serialized value of every option ("section/option"), and an empty entry for every section.
+ * Used to find out which options changed when the config file is reloaded.
+ */
+using config_snapshot_t = std::map<std::string, std::string>;
+static config_snapshot_t last_snapshot;
+
+static config_snapshot_t snapshot_config()
+{
+    config_snapshot_t snapshot;
+    for (auto& section : cfg_manager->get_all_sections())
+    {
+        snapshot[section->get_name()] = "";
+        for (auto& opt : section->get_registered_options())
+        {
+            std::string value;
+            if (auto compound = std::dynamic_pointer_cast<wf::config::compound_option_t>(opt))
+            {
+                for (auto& entry : compound->get_value_untyped())
+                {
+                    for (auto& field : entry)
+                    {
+                        value += field;
+                        value += '\0';
+                    }
+
+                    value += '\n';
+                }
+            } else
+            {
+                value = opt->get_value_str();
+            }
+
+            snapshot[section->get_name() + "/" + opt->get_name()] = std::move(value);
+        }
+    }
+
+    return snapshot;
+}
+
+/** Find the names of all entries which differ between two snapshots. */
+static std::vector<std::string> diff_snapshots(const config_snapshot_t& a, const config_snapshot_t& b)
+{
+    std::vector<std::string> changed;
+    auto it_a = a.begin();
+    auto it_b = b.begin();
+    while ((it_a != a.end()) || (it_b != b.end()))
+    {
+        if ((it_b == b.end()) || ((it_a != a.end()) && (it_a->first < it_b->first)))
+        {
+            changed.push_back(it_a->first);
+            ++it_a;
+        } else if ((it_a == a.end()) || (it_b->first < it_a->first))
+        {
+            changed.push_back(it_b->first);
+            ++it_b;
+        } else
+        {
+            if (it_a->second != it_b->second)
+            {
+                changed.push_back(it_a->first);
+            }
+
+            ++it_a;
+            ++it_b;
+        }
+    }
+
+    return changed;
+}
+
 static int handle_config_updated(int fd, uint32_t mask, void *data)
 {
     if ((mask & WL_EVENT_READABLE) == 0)
@@ -85,7 +157,17 @@ static int handle_config_updated(int fd, uint32_t mask, void *data)
         LOGD("Reloading configuration file");
 
         reload_config(fd);
+        auto snapshot = snapshot_config();
         wf::reload_config_signal ev;
+        ev.changed    = diff_snapshots(last_snapshot, snapshot);
+        last_snapshot = std::move(snapshot);
+
+        if (ev.changed.empty())
+        {
+            LOGD("No options changed");
+            return 0;
+        }
+
         wf::get_core().emit(&ev);
     }
 
@@ -115,6 +197,7 @@ class dynamic_ini_config_t : public wf::config_backend_t
 
         int inotify_fd = inotify_init1(IN_CLOEXEC);
         reload_config(inotify_fd);
+        last_snapshot = snapshot_config();
         add_watch(inotify_fd);
 
         wl_event_loop_add_fd(wl_display_get_event_loop(display),
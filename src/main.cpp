@@ -1,3 +1,4 @@
+#include <chrono>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
@@ -39,6 +40,7 @@ static void print_help()
         std::endl;
     std::cout << " -R,  --damage-rerender   rerender damaged regions" << std::endl;
     std::cout << " -l,  --legacy-wl-drm     use legacy drm for wayland clients" << std::endl;
+    std::cout << "      --startup-profile   log the time spent in each phase of startup" << std::endl;
     std::cout << " -v,  --version           print version and exit" << std::endl;
     exit(0);
 }
@@ -67,6 +69,44 @@ static bool drop_permissions(void)
     return true;
 }
 
+/**
+ * Measures the duration of the startup phases, reported with --startup-profile.
+ */
+struct startup_profile_t
+{
+    bool enabled = false;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point last  = start;
+    std::vector<std::pair<std::string, std::chrono::steady_clock::duration>> phases;
+
+    /** Mark the end of a phase which started when the previous one ended. */
+    void end_phase(const std::string& name)
+    {
+        auto now = std::chrono::steady_clock::now();
+        phases.push_back({name, now - last});
+        last = now;
+    }
+
+    void report()
+    {
+        if (!enabled)
+        {
+            return;
+        }
+
+        using namespace std::chrono;
+        LOGI("Startup profile:");
+        for (auto& [name, duration] : phases)
+        {
+            LOGI("  ", name, ": ", duration_cast<microseconds>(duration).count() / 1000.0, " ms");
+        }
+
+        LOGI("  total: ", duration_cast<microseconds>(last - start).count() / 1000.0, " ms");
+    }
+};
+
+static startup_profile_t startup_profile;
+
 static wf::log::color_mode_t detect_color_mode()
 {
     return isatty(STDOUT_FILENO) ?
@@ -279,6 +319,7 @@ int main(int argc, char *argv[])
         {"damage-debug", no_argument, NULL, 'D'},
         {"damage-rerender", no_argument, NULL, 'R'},
         {"legacy-wl-drm", no_argument, NULL, 'l'},
+        {"startup-profile", no_argument, NULL, 'P'},
         {"with-great-power-comes-great-responsibility", no_argument, NULL, 'r'},
         {"help", no_argument, NULL, 'h'},
         {"version", no_argument, NULL, 'v'},
@@ -319,6 +360,10 @@ int main(int argc, char *argv[])
             allow_root = true;
             break;
 
+          case 'P':
+            startup_profile.enabled = true;
+            break;
+
           case 'h':
             print_help();
             break;
@@ -431,6 +476,7 @@ int main(int argc, char *argv[])
     assert(core.allocator);
     core.egl = wlr_gles2_renderer_get_egl(core.renderer);
     assert(core.egl);
+    startup_profile.end_phase("backend and renderer");
 
     if (!allow_root && !drop_permissions())
     {
@@ -450,9 +496,12 @@ int main(int argc, char *argv[])
     }
 
     LOGD("Using configuration backend: ", config_backend);
+    startup_profile.end_phase("loading config backend");
     core.config_backend = std::unique_ptr<wf::config_backend_t>(backend);
     core.config_backend->init(display, *core.config, config_file);
+    startup_profile.end_phase("config (metadata, defaults and config file)");
     core.init();
+    startup_profile.end_phase("core init");
 
     auto socket = choose_socket(core.display);
     if (!socket)
@@ -474,7 +523,19 @@ int main(int argc, char *argv[])
     }
 
     setenv("WAYLAND_DISPLAY", core.wayland_display.c_str(), 1);
+    startup_profile.end_phase("socket and backend start");
     core.post_init();
+    startup_profile.end_phase("post init (plugins)");
+
+    if (startup_profile.enabled)
+    {
+        // Events queued during startup (e.g. output configuration) are handled before the loop becomes idle.
+        wl_event_loop_add_idle(core.ev_loop, [] (void*)
+        {
+            startup_profile.end_phase("until event loop idle");
+            startup_profile.report();
+        }, nullptr);
+    }
 
     wl_display_run(core.display);
     if (exit_because_signal == SIGINT)
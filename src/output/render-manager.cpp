@@ -14,11 +14,18 @@
 #include "../main.hpp"
 #include "wayfire/workspace-set.hpp"
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <ctime>
+#include <deque>
+#include <functional>
 #include <wayfire/nonstd/reverse.hpp>
 #include <wayfire/nonstd/safe-list.hpp>
 #include <wayfire/util/log.hpp>
 #include <wayfire/nonstd/wlroots-full.hpp>
 #include <wlr/types/wlr_gamma_control_v1.h>
+#include <EGL/egl.h>
+#include <GLES2/gl2ext.h>
 #include <wayfire/output-layout.hpp>
 
 namespace wf
@@ -43,6 +50,12 @@ struct swapchain_damage_manager_t
     wlr_damage_ring damage_ring;
     output_t *wo;
 
+    /**
+     * While the output is magnified, the damage ring tracks damage before magnification. Set by the render
+     * manager to map damage on the screen (in the wlroots damage coordinate system) back to it.
+     */
+    std::function<wf::region_t(const wf::region_t&)> unmagnify_damage;
+
     bool pending_gamma_lut = false;
     wf::wl_idle_call idle_recompute_visibility;
 
@@ -120,7 +133,14 @@ struct swapchain_damage_manager_t
         on_damage.set_callback([&] (void *data)
         {
             auto ev = static_cast<wlr_output_event_damage*>(data);
-            if (wlr_damage_ring_add(&damage_ring, ev->damage))
+            wf::region_t damage;
+            pixman_region32_copy(damage.to_pixman(), ev->damage);
+            if (unmagnify_damage)
+            {
+                damage = unmagnify_damage(damage);
+            }
+
+            if (wlr_damage_ring_add(&damage_ring, damage.to_pixman()))
             {
                 schedule_repaint();
             }
@@ -181,6 +201,9 @@ struct swapchain_damage_manager_t
         {
             schedule_repaint();
         }
+
+        output_damage_signal data{wo, region};
+        wo->emit(&data);
     }
 
     void damage(const wf::geometry_t& box, bool repaint)
@@ -198,6 +221,10 @@ struct swapchain_damage_manager_t
         {
             schedule_repaint();
         }
+
+        wf::region_t region{box};
+        output_damage_signal data{wo, region};
+        wo->emit(&data);
     }
 
     int constant_redraw_counter = 0;
@@ -247,12 +274,22 @@ struct swapchain_damage_manager_t
         frame_object_t& operator =(frame_object_t&&) = delete;
     };
 
-    bool acquire_next_swapchain_buffer(frame_object_t& frame)
+    /**
+     * Set the damage of the frame which is reported to wlroots.
+     *
+     * @param damage The damage in the wlroots damage coordinate system.
+     */
+    void set_frame_damage(frame_object_t& frame, pixman_region32_t *damage)
     {
         int width, height;
         wlr_output_transformed_resolution(output, &width, &height);
-        wlr_region_transform(&frame.state.damage, &damage_ring.current,
+        wlr_region_transform(&frame.state.damage, damage,
             wlr_output_transform_invert(output->transform), width, height);
+    }
+
+    bool acquire_next_swapchain_buffer(frame_object_t& frame)
+    {
+        set_frame_damage(frame, &damage_ring.current);
 
         if (!wlr_output_configure_primary_swapchain(output, &frame.state, &output->swapchain))
         {
@@ -808,6 +845,13 @@ class depth_buffer_manager_t
  * delay is increased by one. If the next frame is delayed, then
  * `increase_window` is doubled, otherwise, it is halved
  * (but it must stay between `MIN_INCREASE_WINDOW` and `MAX_INCREASE_WINDOW`).
+ *
+ * Alternatively, if `core/predictive_repaint_delay` is enabled, the delay is
+ * chosen so that there is enough time left for a given percentile of the
+ * render times of the last `RENDER_TIME_HISTORY` frames. Since only a few
+ * slow frames are needed to raise the percentile, the delay drops within a
+ * few frames after a plugin like blur starts rendering, instead of after a
+ * series of missed frames.
  */
 struct repaint_delay_manager_t
 {
@@ -836,6 +880,13 @@ struct repaint_delay_manager_t
      */
     void start_frame()
     {
+        if (predictive_delay && (max_render_time != -1))
+        {
+            last_pageflip = get_current_time();
+            update_predicted_delay();
+            return;
+        }
+
         if (last_pageflip == -1)
         {
             last_pageflip = get_current_time();
@@ -885,6 +936,16 @@ struct repaint_delay_manager_t
         last_pageflip = get_current_time();
     }
 
+    /**
+     * Report the time needed to render the last frame, from the start of the
+     * repaint until the frame was submitted to the output.
+     */
+    void report_render_time(int64_t render_nsec)
+    {
+        render_times[render_times_count % RENDER_TIME_HISTORY] = render_nsec;
+        ++render_times_count;
+    }
+
     /**
      * @return The delay in milliseconds for the current frame.
      */
@@ -896,6 +957,28 @@ struct repaint_delay_manager_t
   private:
     int delay = 0;
 
+    void update_predicted_delay()
+    {
+        const size_t count = std::min(render_times_count, RENDER_TIME_HISTORY);
+        if (count == 0)
+        {
+            delay = 0;
+            return;
+        }
+
+        std::array<int64_t, RENDER_TIME_HISTORY> sorted;
+        std::copy(render_times.begin(), render_times.begin() + count, sorted.begin());
+
+        const int percentile = clamp((int)render_time_percentile, 0, 100);
+        const size_t idx     = std::min(count - 1, count * percentile / 100);
+        std::nth_element(sorted.begin(), sorted.begin() + idx, sorted.begin() + count);
+
+        const int64_t render_msec = (sorted[idx] + PREDICTION_MARGIN_NSEC + 999'999) / 1'000'000;
+        const int64_t refresh     = this->refresh_nsec / 1'000'000;
+        const int64_t max_delay   = std::max<int64_t>(0, refresh - max_render_time);
+        delay = clamp(refresh - render_msec, int64_t(0), max_delay);
+    }
+
     void update_delay(int delta)
     {
         int config_delay = std::max(0,
@@ -934,13 +1017,343 @@ struct repaint_delay_manager_t
     // Time of last frame
     int64_t last_pageflip = -1; // -1 is invalid
 
+    // Render times of the last frames, for the predictive delay
+    static constexpr size_t RENDER_TIME_HISTORY = 60;
+    static constexpr int64_t PREDICTION_MARGIN_NSEC = 1'000'000; // 1ms
+    std::array<int64_t, RENDER_TIME_HISTORY> render_times;
+    size_t render_times_count = 0;
+
     int64_t refresh_nsec;
     wf::option_wrapper_t<int> max_render_time{"core/max_render_time"};
     wf::option_wrapper_t<bool> dynamic_delay{"workarounds/dynamic_repaint_delay"};
+    wf::option_wrapper_t<bool> predictive_delay{"core/predictive_repaint_delay"};
+    wf::option_wrapper_t<int> render_time_percentile{"core/predictive_render_percentile"};
 
     wf::wl_listener_wrapper on_present;
 };
 
+/**
+ * A struct which collects timing information about the frames of an output.
+ *
+ * The CPU time of each phase is measured with CLOCK_MONOTONIC. If the driver supports
+ * GL_EXT_disjoint_timer_query, the GPU time of the rendering phases is measured with timer queries as well.
+ * Query results become available a few frames later, so they are polled at the start of each frame and
+ * stored in the frame they belong to, if it is still in the history.
+ */
+struct frame_stats_manager_t
+{
+    static constexpr size_t HISTORY_SIZE = 128;
+    static constexpr size_t MAX_PENDING_QUERIES = 4;
+
+    frame_stats_manager_t() = default;
+    ~frame_stats_manager_t()
+    {
+        if (gpu_timers_supported)
+        {
+            OpenGL::render_begin();
+            for (auto& query : queries)
+            {
+                gl_delete_queries(1, &query.id);
+            }
+
+            OpenGL::render_end();
+        }
+    }
+
+    frame_stats_manager_t(const frame_stats_manager_t &) = delete;
+    frame_stats_manager_t(frame_stats_manager_t &&) = delete;
+    frame_stats_manager_t& operator =(const frame_stats_manager_t&) = delete;
+    frame_stats_manager_t& operator =(frame_stats_manager_t&&) = delete;
+
+    /**
+     * A new repaint cycle starts.
+     */
+    void start_frame()
+    {
+        current = {};
+        current.start = get_current_time_ns();
+        last_mark     = current.start;
+    }
+
+    /**
+     * The given phase has ended, account the time since the last phase ended to it.
+     */
+    void end_phase(frame_phase_t phase)
+    {
+        const int64_t now = get_current_time_ns();
+        current.cpu_ns[phase] += now - last_mark;
+        last_mark = now;
+    }
+
+    /**
+     * @return The time since the start of the current frame, in nanoseconds.
+     */
+    int64_t get_elapsed() const
+    {
+        return get_current_time_ns() - current.start;
+    }
+
+    /**
+     * The current frame was painted (or scanned out), store it in the history.
+     */
+    void finish_frame(bool scanout)
+    {
+        current.scanout = scanout;
+        history[painted % HISTORY_SIZE] = current;
+        ++painted;
+        scanout_count += scanout;
+    }
+
+    /**
+     * Record the number of damage rectangles of the current frame before and after merging them.
+     */
+    void set_damage_rects(int before, int after)
+    {
+        current.damage_rects = before;
+        current.damage_rects_merged = after;
+    }
+
+    /**
+     * The repaint cycle ended without a new frame.
+     */
+    void skip_frame()
+    {
+        ++skipped;
+    }
+
+    /**
+     * Start measuring GPU time for the current frame. Requires a current GL context.
+     */
+    void start_gpu_timer()
+    {
+        if (!gpu_timers_checked)
+        {
+            init_gpu_timers();
+        }
+
+        if (!gpu_timers_supported)
+        {
+            return;
+        }
+
+        poll_gpu_timers();
+        auto& query = queries[next_query];
+        if (query.pending)
+        {
+            // The GPU is lagging behind, skip measuring this frame.
+            return;
+        }
+
+        gl_begin_query(GL_TIME_ELAPSED_EXT, query.id);
+        query.pending = true;
+        query.frame   = painted;
+        gpu_timer_running = true;
+        next_query = (next_query + 1) % MAX_PENDING_QUERIES;
+    }
+
+    /**
+     * Stop measuring GPU time for the current frame. Requires a current GL context.
+     */
+    void stop_gpu_timer()
+    {
+        if (gpu_timer_running)
+        {
+            gl_end_query(GL_TIME_ELAPSED_EXT);
+            gpu_timer_running = false;
+        }
+    }
+
+    frame_stats_t get_stats() const
+    {
+        frame_stats_t stats;
+        stats.painted    = painted;
+        stats.skipped    = skipped;
+        stats.scanout    = scanout_count;
+        stats.gpu_timers = gpu_timers_supported;
+
+        const uint64_t count = std::min<uint64_t>(painted, HISTORY_SIZE);
+        stats.frames.reserve(count);
+        for (uint64_t i = painted - count; i < painted; i++)
+        {
+            stats.frames.push_back(history[i % HISTORY_SIZE]);
+        }
+
+        return stats;
+    }
+
+  private:
+    frame_timing_t current;
+    int64_t last_mark = 0;
+
+    std::array<frame_timing_t, HISTORY_SIZE> history;
+    uint64_t painted = 0;
+    uint64_t skipped = 0;
+    uint64_t scanout_count = 0;
+
+    struct gpu_query_t
+    {
+        GLuint id = 0;
+        bool pending   = false;
+        uint64_t frame = 0;
+    };
+
+    std::array<gpu_query_t, MAX_PENDING_QUERIES> queries;
+    size_t next_query = 0;
+    bool gpu_timer_running    = false;
+    bool gpu_timers_checked   = false;
+    bool gpu_timers_supported = false;
+
+    PFNGLGENQUERIESEXTPROC gl_gen_queries;
+    PFNGLDELETEQUERIESEXTPROC gl_delete_queries;
+    PFNGLBEGINQUERYEXTPROC gl_begin_query;
+    PFNGLENDQUERYEXTPROC gl_end_query;
+    PFNGLGETQUERYOBJECTUIVEXTPROC gl_get_query_objectuiv;
+    PFNGLGETQUERYOBJECTUI64VEXTPROC gl_get_query_objectui64v;
+
+    static int64_t get_current_time_ns()
+    {
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec * 1'000'000'000ll + ts.tv_nsec;
+    }
+
+    void init_gpu_timers()
+    {
+        gpu_timers_checked = true;
+
+        auto extensions = (const char*)glGetString(GL_EXTENSIONS);
+        if (!extensions || !strstr(extensions, "GL_EXT_disjoint_timer_query"))
+        {
+            LOGC(RENDER, "GPU timer queries are not supported, frame stats will contain only CPU times.");
+            return;
+        }
+
+        gl_gen_queries = (PFNGLGENQUERIESEXTPROC)eglGetProcAddress("glGenQueriesEXT");
+        gl_delete_queries = (PFNGLDELETEQUERIESEXTPROC)eglGetProcAddress("glDeleteQueriesEXT");
+        gl_begin_query    = (PFNGLBEGINQUERYEXTPROC)eglGetProcAddress("glBeginQueryEXT");
+        gl_end_query = (PFNGLENDQUERYEXTPROC)eglGetProcAddress("glEndQueryEXT");
+        gl_get_query_objectuiv =
+            (PFNGLGETQUERYOBJECTUIVEXTPROC)eglGetProcAddress("glGetQueryObjectuivEXT");
+        gl_get_query_objectui64v =
+            (PFNGLGETQUERYOBJECTUI64VEXTPROC)eglGetProcAddress("glGetQueryObjectui64vEXT");
+
+        if (!gl_gen_queries || !gl_delete_queries || !gl_begin_query || !gl_end_query ||
+            !gl_get_query_objectuiv || !gl_get_query_objectui64v)
+        {
+            LOGE("GL_EXT_disjoint_timer_query is advertised, but its functions could not be loaded!");
+            return;
+        }
+
+        for (auto& query : queries)
+        {
+            gl_gen_queries(1, &query.id);
+        }
+
+        gpu_timers_supported = true;
+    }
+
+    void poll_gpu_timers()
+    {
+        GLint disjoint = 0;
+        GL_CALL(glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint));
+
+        for (auto& query : queries)
+        {
+            if (!query.pending)
+            {
+                continue;
+            }
+
+            GLuint available = 0;
+            gl_get_query_objectuiv(query.id, GL_QUERY_RESULT_AVAILABLE_EXT, &available);
+            if (!available)
+            {
+                continue;
+            }
+
+            GLuint64 elapsed = 0;
+            gl_get_query_objectui64v(query.id, GL_QUERY_RESULT_EXT, &elapsed);
+            query.pending = false;
+
+            // Results are meaningless if a disjoint operation (e.g GPU reset) happened in the meantime,
+            // and the frame may have already been evicted from the history.
+            if (!disjoint && (painted - query.frame <= HISTORY_SIZE))
+            {
+                history[query.frame % HISTORY_SIZE].gpu_ns = elapsed;
+            }
+        }
+    }
+};
+
+/**
+ * Merge the rectangles of a damage region if there are too many of them.
+ *
+ * Every rectangle of the damage results in a separate scissor and draw call in every render instance which
+ * it intersects, so repainting a few more pixels is usually cheaper than drawing hundreds of small
+ * rectangles (for example, from a terminal which updates many small areas).
+ *
+ * If the bounding box of the region wastes at most @max_waste of its area, the region is replaced by its
+ * bounding box. Otherwise, the bounding box is split into a grid of about @max_rects tiles, and the
+ * damage in each tile is replaced by its bounding box.
+ */
+static void simplify_damage(wf::region_t& damage, int max_rects, double max_waste)
+{
+    const int nr_rects = damage.end() - damage.begin();
+    if ((max_rects <= 0) || (nr_rects <= max_rects))
+    {
+        return;
+    }
+
+    const auto extents = wlr_box_from_pixman_box(damage.get_extents());
+    int64_t damaged_area = 0;
+    for (const auto& rect : damage)
+    {
+        damaged_area += int64_t(rect.x2 - rect.x1) * (rect.y2 - rect.y1);
+    }
+
+    const int64_t bbox_area = int64_t(extents.width) * extents.height;
+    if (bbox_area - damaged_area <= max_waste * bbox_area)
+    {
+        damage = extents;
+        return;
+    }
+
+    const int grid = std::max(1, (int)std::sqrt(max_rects));
+    const int tile_width  = (extents.width + grid - 1) / grid;
+    const int tile_height = (extents.height + grid - 1) / grid;
+
+    std::vector<pixman_box32_t> tiles(grid * grid, pixman_box32_t{INT32_MAX, INT32_MAX, INT32_MIN, INT32_MIN});
+    for (const auto& rect : damage)
+    {
+        const int tx1 = (rect.x1 - extents.x) / tile_width;
+        const int ty1 = (rect.y1 - extents.y) / tile_height;
+        const int tx2 = (rect.x2 - 1 - extents.x) / tile_width;
+        const int ty2 = (rect.y2 - 1 - extents.y) / tile_height;
+        for (int ty = ty1; ty <= ty2; ty++)
+        {
+            for (int tx = tx1; tx <= tx2; tx++)
+            {
+                auto& tile = tiles[ty * grid + tx];
+                const int x1 = extents.x + tx * tile_width;
+                const int y1 = extents.y + ty * tile_height;
+                tile.x1 = std::min(tile.x1, std::max(rect.x1, x1));
+                tile.y1 = std::min(tile.y1, std::max(rect.y1, y1));
+                tile.x2 = std::max(tile.x2, std::min(rect.x2, x1 + tile_width));
+                tile.y2 = std::max(tile.y2, std::min(rect.y2, y1 + tile_height));
+            }
+        }
+    }
+
+    damage.clear();
+    for (const auto& tile : tiles)
+    {
+        if (tile.x1 < tile.x2)
+        {
+            damage |= wlr_box_from_pixman_box(tile);
+        }
+    }
+}
+
 class wf::render_manager::impl
 {
   public:
@@ -954,8 +1367,11 @@ class wf::render_manager::impl
     std::unique_ptr<postprocessing_manager_t> postprocessing;
     std::unique_ptr<depth_buffer_manager_t> depth_buffer_manager;
     std::unique_ptr<repaint_delay_manager_t> delay_manager;
+    std::unique_ptr<frame_stats_manager_t> frame_stats;
 
     wf::option_wrapper_t<wf::color_t> background_color_opt;
+    wf::option_wrapper_t<int> damage_max_rects{"core/damage_max_rects"};
+    wf::option_wrapper_t<double> damage_max_waste{"core/damage_max_waste"};
 
     impl(output_t *o) : output(o), env_allow_scanout(check_scanout_enabled())
     {
@@ -964,6 +1380,7 @@ class wf::render_manager::impl
         postprocessing = std::make_unique<postprocessing_manager_t>(o);
         depth_buffer_manager = std::make_unique<depth_buffer_manager_t>();
         delay_manager = std::make_unique<repaint_delay_manager_t>(o);
+        frame_stats   = std::make_unique<frame_stats_manager_t>();
 
         on_frame.set_callback([&] (void*)
         {
@@ -1057,7 +1474,8 @@ class wf::render_manager::impl
     bool do_direct_scanout()
     {
         const bool can_scanout = !output_inhibit_counter && effects->can_scanout() &&
-            postprocessing->can_scanout() && wlr_output_is_direct_scanout_allowed(output->handle);
+            postprocessing->can_scanout() && !is_magnified() &&
+            wlr_output_is_direct_scanout_allowed(output->handle);
 
         if (!can_scanout || !env_allow_scanout)
         {
@@ -1078,6 +1496,145 @@ class wf::render_manager::impl
         return swap_damage;
     }
 
+    double magnification = 1.0;
+    wf::pointf_t magnification_origin;
+    bool magnification_nearest = false;
+
+    /**
+     * Same as render_manager::set_magnification()
+     */
+    void set_magnification(double factor, wf::pointf_t origin, bool nearest)
+    {
+        if (factor <= 1.0)
+        {
+            factor  = 1.0;
+            origin  = {0, 0};
+            nearest = false;
+        }
+
+        if ((factor == magnification) && (origin.x == magnification_origin.x) &&
+            (origin.y == magnification_origin.y) && (nearest == magnification_nearest))
+        {
+            return;
+        }
+
+        magnification = factor;
+        magnification_origin  = origin;
+        magnification_nearest = nearest;
+        if (is_magnified())
+        {
+            damage_manager->unmagnify_damage = [=] (const wf::region_t& damage)
+            {
+                return unmagnify_damage(damage);
+            };
+        } else
+        {
+            damage_manager->unmagnify_damage = nullptr;
+        }
+
+        damage_manager->damage_whole();
+    }
+
+    bool is_magnified() const
+    {
+        return magnification > 1.0;
+    }
+
+    /**
+     * The box which the whole (magnified) output covers on the screen, in the wlroots damage coordinate
+     * system. It is computed in output pixels, so that panning is smooth even with large factors.
+     */
+    wlr_box get_magnified_box() const
+    {
+        auto screen   = damage_manager->get_wlr_damage_box();
+        auto geometry = output->get_relative_geometry();
+        const double sx = magnification * screen.width / geometry.width;
+        const double sy = magnification * screen.height / geometry.height;
+
+        return wlr_box{
+            (int)std::round(-magnification_origin.x * sx),
+            (int)std::round(-magnification_origin.y * sy),
+            (int)std::round(geometry.width * sx),
+            (int)std::round(geometry.height * sy),
+        };
+    }
+
+    /**
+     * The part of the output which is visible while magnified, in output-local coordinates.
+     */
+    wf::geometry_t get_magnified_source() const
+    {
+        auto geometry = output->get_relative_geometry();
+        const int x1  = std::floor(magnification_origin.x);
+        const int y1  = std::floor(magnification_origin.y);
+        const int x2  = std::ceil(magnification_origin.x + geometry.width / magnification);
+        const int y2  = std::ceil(magnification_origin.y + geometry.height / magnification);
+
+        return wf::geometry_intersection({x1, y1, x2 - x1, y2 - y1}, geometry);
+    }
+
+    /**
+     * Map the target framebuffer to the magnified box, so that the scenegraph is rendered directly at the
+     * magnified size.
+     */
+    void magnify_target(wf::render_target_t& target) const
+    {
+        // The wlroots damage coordinate system is the framebuffer before applying the output transform, so
+        // we can reuse the target's transform (including the y-invert workaround) to find the subbuffer.
+        wf::render_target_t screen = target;
+        screen.geometry = damage_manager->get_wlr_damage_box();
+        screen.scale    = 1.0;
+        target.subbuffer = screen.framebuffer_box_from_geometry_box(get_magnified_box());
+    }
+
+    /**
+     * Map damage in output-local coordinates to the screen through the magnification, in the wlroots damage
+     * coordinate system.
+     */
+    wf::region_t magnify_damage(const wf::region_t& damage) const
+    {
+        auto box = get_magnified_box();
+        auto geometry   = output->get_relative_geometry();
+        const double sx = 1.0 * box.width / geometry.width;
+        const double sy = 1.0 * box.height / geometry.height;
+
+        wf::region_t result;
+        for (const auto& rect : damage)
+        {
+            const int x1 = std::floor(rect.x1 * sx);
+            const int y1 = std::floor(rect.y1 * sy);
+            const int x2 = std::ceil(rect.x2 * sx);
+            const int y2 = std::ceil(rect.y2 * sy);
+            result |= wlr_box{box.x + x1, box.y + y1, x2 - x1, y2 - y1};
+        }
+
+        return result;
+    }
+
+    /**
+     * The inverse of magnify_damage(): map damage on the screen, in the wlroots damage coordinate system,
+     * to the output-local coordinates it was magnified from, scaled like the damage ring.
+     */
+    wf::region_t unmagnify_damage(const wf::region_t& damage) const
+    {
+        auto box = get_magnified_box();
+        auto geometry   = output->get_relative_geometry();
+        const double sx = output->handle->scale * geometry.width / box.width;
+        const double sy = output->handle->scale * geometry.height / box.height;
+
+        wf::region_t result;
+        for (const auto& rect : damage)
+        {
+            const int x1 = std::floor((rect.x1 - box.x) * sx);
+            const int y1 = std::floor((rect.y1 - box.y) * sy);
+            const int x2 = std::ceil((rect.x2 - box.x) * sx);
+            const int y2 = std::ceil((rect.y2 - box.y) * sy);
+            result |= wlr_box{x1, y1, x2 - x1, y2 - y1};
+        }
+
+        return result;
+    }
+
     /**
      * Render an output. Either calls the built-in renderer, or the render hook
      * of a plugin
@@ -1099,17 +1656,46 @@ class wf::render_manager::impl
         params.instances = &damage_manager->render_instances;
         params.damage    = damage_manager->get_ws_damage(
             output->wset()->get_current_workspace());
+        if (is_magnified())
+        {
+            // Parts of the output which are not visible do not need to be repainted.
+            params.damage &= get_magnified_source();
+        }
+
         params.damage += wf::origin(output->get_layout_geometry());
 
-        params.target = postprocessing->get_target_framebuffer().translated(
-            wf::origin(output->get_layout_geometry()));
+        const int nr_rects = params.damage.end() - params.damage.begin();
+        simplify_damage(params.damage, damage_max_rects, damage_max_waste);
+        frame_stats->set_damage_rects(nr_rects, params.damage.end() - params.damage.begin());
+
+        auto target = postprocessing->get_target_framebuffer();
+        if (is_magnified())
+        {
+            magnify_target(target);
+        }
+
+        params.target = target.translated(wf::origin(output->get_layout_geometry()));
         params.background_color = background_color_opt;
         params.reference_output = this->output;
 
+        if (is_magnified())
+        {
+            // The textures are drawn at the magnified size, so their filter decides the interpolation.
+            OpenGL::set_texture_mag_filter(magnification_nearest ? GL_NEAREST : GL_LINEAR);
+        }
+
         this->swap_damage = scene::run_render_pass(params,
             scene::RPASS_CLEAR_BACKGROUND | scene::RPASS_EMIT_SIGNALS);
+        OpenGL::set_texture_mag_filter(0);
         swap_damage += -wf::origin(output->get_layout_geometry());
-        swap_damage  = swap_damage * output->handle->scale;
+        if (is_magnified())
+        {
+            swap_damage = magnify_damage(swap_damage);
+        } else
+        {
+            swap_damage = swap_damage * output->handle->scale;
+        }
+
         swap_damage &= damage_manager->get_wlr_damage_box();
         if (runtime_config.damage_debug)
         {
@@ -1133,32 +1719,55 @@ class wf::render_manager::impl
      */
     void paint()
     {
+        frame_stats->start_frame();
+
         /* Part 1: frame setup: query damage, etc. */
         effects->run_effects(OUTPUT_EFFECT_PRE);
         effects->run_effects(OUTPUT_EFFECT_DAMAGE);
+        frame_stats->end_phase(FRAME_PHASE_EFFECTS);
 
-        if (do_direct_scanout())
+        const bool scanout = do_direct_scanout();
+        frame_stats->end_phase(FRAME_PHASE_SCANOUT);
+        if (scanout)
         {
             // Yet another optimization: if we can directly scanout, we should
             // stop the rest of the repaint cycle.
+            frame_stats->finish_frame(true);
             return;
         }
 
+        if (is_magnified() && effects->effects[OUTPUT_EFFECT_OVERLAY].size())
+        {
+            // Overlay effects are drawn on the screen without magnification, so their damage (which cannot be
+            // told apart from the scenegraph's) is also where they are on the screen. Repaint the part of the
+            // magnified source which covers it there.
+            const double scale = output->handle->scale;
+            auto on_screen     = damage_manager->get_scheduled_damage() * scale;
+            damage_manager->damage(
+                (unmagnify_damage(on_screen) * (1.0 / scale)) & get_magnified_source(), false);
+        }
+
         auto next_frame = damage_manager->start_frame();
         if (!next_frame)
         {
             // Optimization: the output doesn't need a new frame (so isn't damaged), so we can
             // just skip the whole repaint
             delay_manager->skip_frame();
+            frame_stats->skip_frame();
             return;
         }
 
         /* Part 2: call the renderer, which sets swap_damage and draws the scenegraph */
         update_bound_output(next_frame->buffer);
+        OpenGL::render_begin();
+        frame_stats->start_gpu_timer();
+        OpenGL::render_end();
         render_output();
+        frame_stats->end_phase(FRAME_PHASE_RENDER);
 
         /* Part 3: overlay effects */
         effects->run_effects(OUTPUT_EFFECT_OVERLAY);
+        frame_stats->end_phase(FRAME_PHASE_OVERLAY);
 
         /* Part 4: finalize the scene: postprocessing effects */
         if (postprocessing->post_effects.size())
@@ -1181,13 +1790,26 @@ class wf::render_manager::impl
         OpenGL::render_begin();
         wlr_output_add_software_cursors_to_render_pass(output->handle, next_frame->render_pass,
             swap_damage.to_pixman());
+        frame_stats->stop_gpu_timer();
         OpenGL::render_end();
+        frame_stats->end_phase(FRAME_PHASE_POSTPROCESS);
 
         /* Part 6: finalize frame: swap buffers, send frame_done, etc */
+        if (is_magnified())
+        {
+            // The damage ring tracks damage before magnification, report what actually changed on screen.
+            damage_manager->set_frame_damage(*next_frame, swap_damage.to_pixman());
+        }
+
         damage_manager->swap_buffers(std::move(next_frame), swap_damage);
         OpenGL::unbind_output(output);
         swap_damage.clear();
+        frame_stats->end_phase(FRAME_PHASE_SWAP);
+        delay_manager->report_render_time(frame_stats->get_elapsed());
+
         post_paint();
+        frame_stats->end_phase(FRAME_PHASE_EFFECTS);
+        frame_stats->finish_frame(false);
     }
 
     /**
@@ -1203,6 +1825,30 @@ class wf::render_manager::impl
     }
 };
 
+/**
+ * Storage for the render instructions of render passes. It is reused between
+ * render passes, so that steady-state frames do not need to allocate memory
+ * for the instruction lists.
+ *
+ * Render passes may be nested (for example, a render instance may run a
+ * render pass for its children into an auxiliary buffer), so there is a
+ * separate list for each nesting level.
+ */
+struct render_instructions_pool_t
+{
+    // A deque, so that references to the lists stay valid when a nested render pass adds a new level.
+    std::deque<std::vector<scene::render_instruction_t>> levels;
+    size_t depth = 0;
+    uint64_t allocations = 0;
+};
+
+static render_instructions_pool_t instructions_pool;
+
+uint64_t scene::get_render_pass_allocations()
+{
+    return instructions_pool.allocations;
+}
+
 wf::region_t scene::run_render_pass(
     const render_pass_params_t& params, uint32_t flags)
 {
@@ -1218,13 +1864,29 @@ wf::region_t scene::run_render_pass(
     wf::region_t swap_damage = accumulated_damage;
 
     // Gather instructions
-    std::vector<wf::scene::render_instruction_t> instructions;
+    if (instructions_pool.depth == instructions_pool.levels.size())
+    {
+        instructions_pool.levels.emplace_back();
+    }
+
+    auto& instructions = instructions_pool.levels[instructions_pool.depth++];
+#ifndef NDEBUG
+    const size_t capacity = instructions.capacity();
+#endif
     for (auto& inst : *params.instances)
     {
         inst->schedule_instructions(instructions,
             params.target, accumulated_damage);
     }
 
+#ifndef NDEBUG
+    if (instructions.capacity() != capacity)
+    {
+        instructions_pool.allocations++;
+    }
+
+#endif
+
     // Clear visible background areas
     if (flags & RPASS_CLEAR_BACKGROUND)
     {
@@ -1248,6 +1910,11 @@ wf::region_t scene::run_render_pass(
         }
     }
 
+    // Keep the allocated storage for the next render pass, but release the
+    // instructions themselves, as they may hold references to resources.
+    instructions.clear();
+    instructions_pool.depth--;
+
     if (flags & RPASS_EMIT_SIGNALS)
     {
         render_pass_end_signal end_ev;
@@ -1366,11 +2033,21 @@ wf::render_target_t render_manager::get_target_framebuffer() const
     return pimpl->postprocessing->get_target_framebuffer();
 }
 
+void render_manager::set_magnification(double factor, wf::pointf_t origin, bool nearest)
+{
+    pimpl->set_magnification(factor, origin, nearest);
+}
+
 void render_manager::set_require_depth_buffer(bool require)
 {
     return pimpl->depth_buffer_manager->set_required(require);
 }
 
+frame_stats_t render_manager::get_frame_stats() const
+{
+    return pimpl->frame_stats->get_stats();
+}
+
 void priv_render_manager_clear_instances(wf::render_manager *manager)
 {
     manager->pimpl->damage_manager->render_instances.clear();
@@ -15,6 +15,7 @@
 #include <wayfire/seat.hpp>
 
 #include <wayfire/scene-operations.hpp>
+#include <wayfire/unstable/translation-node.hpp>
 
 #include "../view/view-impl.hpp"
 #include "wayfire/debug.hpp"
@@ -166,14 +167,25 @@ static size_t find_index_in_parent(wf::scene::node_t *x, wf::scene::node_t *pare
     return it - children.begin();
 }
 
-class workspace_set_root_node_t : public wf::scene::floating_inner_node_t
+/**
+ * The root node of a workspace set contains all of its views.
+ *
+ * It is a translation node (with a zero offset), so that its render instance keeps the instances of the
+ * views in a separate list. When a view is mapped, unmapped or restacked, only that list is regenerated,
+ * instead of the render instances of the whole scenegraph.
+ *
+ * Workspace sets may contain many views, so the node also keeps a spatial index of them to speed up
+ * finding the view under the cursor.
+ */
+class workspace_set_root_node_t : public wf::scene::translation_node_t
 {
     uint64_t index;
 
   public:
-    workspace_set_root_node_t(uint64_t index) : floating_inner_node_t(true)
+    workspace_set_root_node_t(uint64_t index) : translation_node_t(true)
     {
         this->index = index;
+        set_spatial_index(true);
     }
 
     std::string stringify() const override
@@ -31,12 +31,42 @@ class workspace_stream_node_t::workspace_stream_instance_t : public scene::
         };
     }
 
-  public:
-    workspace_stream_instance_t(workspace_stream_node_t *self,
-        scene::damage_callback push_damage)
+    scene::damage_callback push_damage;
+
+    // The children of the output nodes are copied into the list of instances, so changes of the children
+    // which the output nodes handle locally have to be tracked here.
+    wf::signal::connection_t<scene::node_regen_instances_signal> on_output_node_regen =
+        [=] (scene::node_regen_instances_signal*)
     {
-        this->self = self;
-        auto translate_and_push_damage = [this, push_damage] (wf::region_t damage)
+        regen_instances();
+        push_damage(self->get_bounding_box());
+    };
+
+    // Similarly, the layer nodes handle locally the output nodes being added, removed, enabled or disabled,
+    // so the list of output nodes has to be refreshed here.
+    wf::signal::connection_t<scene::node_regen_instances_signal> on_layer_regen =
+        [=] (scene::node_regen_instances_signal*)
+    {
+        connect_output_nodes();
+        regen_instances();
+        push_damage(self->get_bounding_box());
+    };
+
+    void connect_output_nodes()
+    {
+        on_output_node_regen.disconnect();
+        for (auto& output_node : wf::collect_output_nodes(wf::get_core().scene(), self->output))
+        {
+            output_node->connect(&on_output_node_regen);
+        }
+    }
+
+    void regen_instances()
+    {
+        instances.clear();
+        is_desktop_environment.clear();
+
+        auto translate_and_push_damage = [this] (wf::region_t damage)
         {
             damage += -get_offset();
             push_damage(damage);
@@ -70,6 +100,23 @@ class workspace_stream_node_t::workspace_stream_instance_t : public scene::
         }
     }
 
+  public:
+    workspace_stream_instance_t(workspace_stream_node_t *self,
+        scene::damage_callback push_damage)
+    {
+        this->self = self;
+        this->push_damage = push_damage;
+        regen_instances();
+        connect_output_nodes();
+
+        // Changes of the layers themselves reach the root node, in which case all render instances are
+        // regenerated.
+        for (auto& layer : wf::get_core().scene()->layers)
+        {
+            layer->connect(&on_layer_regen);
+        }
+    }
+
     void schedule_instructions(
         std::vector<scene::render_instruction_t>& instructions,
         const wf::render_target_t& target, wf::region_t& damage) override
@@ -389,7 +389,7 @@ wayfire_layer_shell_view::wayfire_layer_shell_view(wlr_layer_surface_v1 *lsurf)
     this->main_surface = std::make_shared<wf::scene::wlr_surface_node_t>(lsurf->surface, true);
 
     LOGD("Create a layer surface: namespace ", lsurf->namespace_t, " layer ", lsurf->current.layer);
-    role = wf::VIEW_ROLE_DESKTOP_ENVIRONMENT;
+    set_role(wf::VIEW_ROLE_DESKTOP_ENVIRONMENT);
     std::memset(&this->prev_state, 0, sizeof(prev_state));
     lsurface->data = dynamic_cast<wf::view_interface_t*>(this);
 
@@ -1,11 +1,141 @@
 #include <string>
+#include <limits>
 #include <wayfire/scene.hpp>
 #include <wayfire/unstable/translation-node.hpp>
+#include <wayfire/view-transform.hpp>
 #include <wayfire/debug.hpp>
 
+/**
+ * Transformers are often changed directly (for example by animations), without
+ * scene::update(), so the bounding box of a node with transformers may change
+ * at any time.
+ */
+static bool has_transformers(const wf::scene::node_ptr& node)
+{
+    if (auto transform_manager = dynamic_cast<wf::scene::transform_manager_node_t*>(node.get()))
+    {
+        return transform_manager->has_transformers();
+    }
+
+    for (auto& ch : node->get_children())
+    {
+        if (has_transformers(ch))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * A uniform grid over the bounding box of the node's children. Each cell
+ * contains the indices of the children whose bounding box intersects the
+ * cell, sorted from top to bottom.
+ *
+ * Children with transformers are not added to the grid. Instead, they are
+ * kept in a separate list, and their bounding box is checked on each lookup.
+ */
+struct wf::scene::translation_node_t::spatial_index_t
+{
+    static constexpr int GRID_SIZE = 16;
+
+    bool dirty = true;
+    wf::geometry_t bounds;
+    int cell_width;
+    int cell_height;
+    std::vector<wf::geometry_t> child_bbox;
+    std::vector<std::vector<uint32_t>> cells = std::vector<std::vector<uint32_t>>(GRID_SIZE * GRID_SIZE);
+    std::vector<uint32_t> transformed;
+
+    void rebuild(const std::vector<node_ptr>& children)
+    {
+        dirty = false;
+        child_bbox.clear();
+        transformed.clear();
+        for (auto& cell : cells)
+        {
+            cell.clear();
+        }
+
+        int min_x = std::numeric_limits<int>::max();
+        int min_y = std::numeric_limits<int>::max();
+        int max_x = std::numeric_limits<int>::min();
+        int max_y = std::numeric_limits<int>::min();
+        for (uint32_t i = 0; i < children.size(); i++)
+        {
+            if (has_transformers(children[i]))
+            {
+                transformed.push_back(i);
+                child_bbox.push_back({0, 0, 0, 0});
+                continue;
+            }
+
+            auto bbox = children[i]->get_bounding_box();
+            child_bbox.push_back(bbox);
+            if ((bbox.width > 0) && (bbox.height > 0))
+            {
+                min_x = std::min(min_x, bbox.x);
+                min_y = std::min(min_y, bbox.y);
+                max_x = std::max(max_x, bbox.x + bbox.width);
+                max_y = std::max(max_y, bbox.y + bbox.height);
+            }
+        }
+
+        if (min_x >= max_x)
+        {
+            bounds = {0, 0, 0, 0};
+            return;
+        }
+
+        bounds = {min_x, min_y, max_x - min_x, max_y - min_y};
+        cell_width  = (bounds.width + GRID_SIZE - 1) / GRID_SIZE;
+        cell_height = (bounds.height + GRID_SIZE - 1) / GRID_SIZE;
+        for (uint32_t i = 0; i < child_bbox.size(); i++)
+        {
+            const auto& bbox = child_bbox[i];
+            if ((bbox.width <= 0) || (bbox.height <= 0))
+            {
+                continue;
+            }
+
+            const int x1 = (bbox.x - bounds.x) / cell_width;
+            const int y1 = (bbox.y - bounds.y) / cell_height;
+            const int x2 = (bbox.x + bbox.width - 1 - bounds.x) / cell_width;
+            const int y2 = (bbox.y + bbox.height - 1 - bounds.y) / cell_height;
+            for (int y = y1; y <= y2; y++)
+            {
+                for (int x = x1; x <= x2; x++)
+                {
+                    cells[y * GRID_SIZE + x].push_back(i);
+                }
+            }
+        }
+    }
+
+    const std::vector<uint32_t> *get_cell(const wf::pointf_t& at) const
+    {
+        if (!(bounds & at))
+        {
+            return nullptr;
+        }
+
+        const int x = std::min((int)(at.x - bounds.x) / cell_width, GRID_SIZE - 1);
+        const int y = std::min((int)(at.y - bounds.y) / cell_height, GRID_SIZE - 1);
+        return &cells[y * GRID_SIZE + x];
+    }
+};
+
 wf::scene::translation_node_t::translation_node_t(bool is_structure) :
     wf::scene::floating_inner_node_t(is_structure)
-{}
+{
+    on_children_changed = [=] (node_regen_instances_signal *ev)
+    {
+        invalidate_spatial_index();
+    };
+}
+
+wf::scene::translation_node_t::~translation_node_t() = default;
 
 wf::pointf_t wf::scene::translation_node_t::to_local(const wf::pointf_t& point)
 {
@@ -46,8 +176,90 @@ void wf::scene::translation_node_t::set_offset(wf::point_t offset)
     this->offset = offset;
 }
 
+void wf::scene::translation_node_t::set_spatial_index(bool enabled)
+{
+    if (enabled && !spatial_index)
+    {
+        spatial_index = std::make_unique<spatial_index_t>();
+        // scene::update() asks the node to regenerate its render instances when its own list of children
+        // changes. Changes of the children are reported to optimize_update().
+        this->connect(&on_children_changed);
+    } else if (!enabled)
+    {
+        spatial_index.reset();
+        on_children_changed.disconnect();
+    }
+}
+
+void wf::scene::translation_node_t::invalidate_spatial_index()
+{
+    if (spatial_index)
+    {
+        spatial_index->dirty = true;
+    }
+}
+
+std::optional<wf::scene::input_node_t> wf::scene::translation_node_t::find_node_at(const wf::pointf_t& at)
+{
+    if (!spatial_index)
+    {
+        return node_t::find_node_at(at);
+    }
+
+    if (spatial_index->dirty)
+    {
+        spatial_index->rebuild(get_children());
+    }
+
+    static const std::vector<uint32_t> empty_cell;
+    auto local = this->to_local(at);
+    auto cell  = spatial_index->get_cell(local);
+    if (!cell)
+    {
+        cell = &empty_cell;
+    }
+
+    // Visit the children in the cell and the transformed children together, from top to bottom.
+    const auto& transformed = spatial_index->transformed;
+    size_t next_in_cell = 0, next_transformed = 0;
+    while ((next_in_cell < cell->size()) || (next_transformed < transformed.size()))
+    {
+        uint32_t i;
+        wf::geometry_t bbox;
+        if ((next_transformed >= transformed.size()) ||
+            ((next_in_cell < cell->size()) && ((*cell)[next_in_cell] < transformed[next_transformed])))
+        {
+            i    = (*cell)[next_in_cell++];
+            bbox = spatial_index->child_bbox[i];
+        } else
+        {
+            i    = transformed[next_transformed++];
+            bbox = get_children()[i]->get_bounding_box();
+        }
+
+        auto& node = get_children()[i];
+        if (!node->is_enabled() || !(bbox & local))
+        {
+            continue;
+        }
+
+        auto child_node = node->find_node_at(local);
+        if (child_node.has_value())
+        {
+            return child_node;
+        }
+    }
+
+    return {};
+}
+
 uint32_t wf::scene::translation_node_t::optimize_update(uint32_t flags)
 {
+    if (flags & (update_flag::GEOMETRY | update_flag::CHILDREN_LIST | update_flag::ENABLED))
+    {
+        invalidate_spatial_index();
+    }
+
     return optimize_nested_render_instances(shared_from_this(), flags);
 }
 
@@ -65,9 +277,10 @@ wf::scene::translation_node_instance_t::translation_node_instance_t(
     };
     self->connect(&on_node_damage);
 
-    on_regen_instances = [=] (auto)
+    on_regen_instances = [=] (wf::scene::node_regen_instances_signal *ev)
     {
         regen_instances();
+        ev->handled = true;
     };
     self->connect(&on_regen_instances);
     regen_instances();
@@ -75,20 +288,13 @@ wf::scene::translation_node_instance_t::translation_node_instance_t(
 
 void wf::scene::translation_node_instance_t::regen_instances()
 {
-    children.clear();
     auto push_damage_child = [=] (wf::region_t child_damage)
     {
         child_damage += self->get_offset();
         push_damage(child_damage);
     };
 
-    for (auto& ch : self->get_children())
-    {
-        if (ch->is_enabled())
-        {
-            ch->gen_render_instances(children, push_damage_child, shown_on);
-        }
-    }
+    regen_children_instances(self.get(), children, children_info, push_damage_child, shown_on);
 }
 
 void wf::scene::translation_node_instance_t::schedule_instructions(
@@ -2,6 +2,7 @@
 #include <wayfire/util/log.hpp>
 #include <wayfire/workarea.hpp>
 #include "../core/core-impl.hpp"
+#include "../core/matcher-cache.hpp"
 #include "view-impl.hpp"
 #include "wayfire/debug.hpp"
 #include "wayfire/geometry.hpp"
@@ -24,6 +25,10 @@
 void wf::view_interface_t::set_role(view_role_t new_role)
 {
     role = new_role;
+    if (auto cache = get_data<wf::matcher_cache_t>())
+    {
+        cache->results.clear();
+    }
 }
 
 std::string wf::view_interface_t::to_string() const
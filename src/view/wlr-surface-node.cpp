@@ -341,8 +341,8 @@ class wf::scene::wlr_surface_node_t::wlr_surface_render_instance_t : public rend
 
         // use GL_NEAREST for integer scale.
         // GL_NEAREST makes scaled text blocky instead of blurry, which looks better
-        // but only for integer scale.
-        if (target.scale - floor(target.scale) < 0.001)
+        // but only for integer scale. A filter forced for the whole output takes precedence.
+        if (!OpenGL::get_texture_mag_filter() && (target.scale - floor(target.scale) < 0.001))
         {
             GL_CALL(glTexParameteri(texture.target, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
         }
@@ -137,7 +137,7 @@ class wayfire_unmanaged_xwayland_view : public wayfire_xwayland_view_internal_ba
         LOGE("new unmanaged xwayland surface ", xw->title, " class: ", xw->class_t,
             " instance: ", xw->instance);
 
-        role = wf::VIEW_ROLE_UNMANAGED;
+        set_role(wf::VIEW_ROLE_UNMANAGED);
         on_set_geometry.set_callback([&] (void*) { update_geometry_from_xsurface(); });
         on_set_geometry.connect(&xw->events.set_geometry);
         _initialize();
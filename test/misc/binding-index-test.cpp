@@ -0,0 +1,130 @@
+#include "core/seat/binding-index.hpp"
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+#include <chrono>
+
+template<class T>
+static wf::option_sptr_t<T> make_option(const std::string& value)
+{
+    auto parsed = wf::option_type::from_string<T>(value);
+    REQUIRE(parsed.has_value());
+    return std::make_shared<wf::config::option_t<T>>("test", parsed.value());
+}
+
+static wf::keybinding_t key(const std::string& value)
+{
+    return wf::option_type::from_string<wf::keybinding_t>(value).value();
+}
+
+static wf::buttonbinding_t button(const std::string& value)
+{
+    return wf::option_type::from_string<wf::buttonbinding_t>(value).value();
+}
+
+struct bindings_t
+{
+    wf::binding_container_t<wf::keybinding_t, wf::key_callback> keys;
+    wf::binding_container_t<wf::keybinding_t, wf::axis_callback> axes;
+    wf::binding_container_t<wf::buttonbinding_t, wf::button_callback> buttons;
+    wf::binding_container_t<wf::activatorbinding_t, wf::activator_callback> activators;
+    wf::binding_index_t index{keys, axes, buttons, activators};
+
+    template<class Option, class Callback>
+    void add(wf::binding_container_t<Option, Callback>& container, wf::option_sptr_t<Option> opt)
+    {
+        auto bnd = std::make_unique<wf::binding_t<Option, Callback>>();
+        bnd->activated_by = opt;
+        container.emplace_back(std::move(bnd));
+        index.invalidate();
+    }
+};
+
+TEST_CASE("Binding index finds key, button and axis bindings")
+{
+    bindings_t b;
+    b.add(b.keys, make_option<wf::keybinding_t>("<super> KEY_A"));
+    b.add(b.keys, make_option<wf::keybinding_t>("<super> KEY_B"));
+    b.add(b.keys, make_option<wf::keybinding_t>("<super> KEY_A"));
+    b.add(b.buttons, make_option<wf::buttonbinding_t>("<alt> BTN_LEFT"));
+    b.add(b.axes, make_option<wf::keybinding_t>("<ctrl>"));
+
+    auto& a = b.index.find_key(key("<super> KEY_A"));
+    REQUIRE(a.bindings.size() == 2);
+    REQUIRE(a.bindings[0] == b.keys[0].get());
+    REQUIRE(a.bindings[1] == b.keys[2].get());
+    REQUIRE(a.activators.empty());
+
+    REQUIRE(b.index.find_key(key("KEY_A")).bindings.empty());
+    REQUIRE(b.index.find_key(key("<alt> KEY_B")).bindings.empty());
+    REQUIRE(b.index.find_button(button("<alt> BTN_LEFT")).bindings.size() == 1);
+    REQUIRE(b.index.find_button(button("BTN_LEFT")).bindings.empty());
+    REQUIRE(b.index.find_axis(key("<ctrl>").get_modifiers()).bindings.size() == 1);
+    REQUIRE(b.index.find_axis(0).bindings.empty());
+}
+
+TEST_CASE("Binding index splits activator bindings")
+{
+    bindings_t b;
+    b.add(b.activators, make_option<wf::activatorbinding_t>("<super> KEY_E | <super> BTN_RIGHT | <super> KEY_E"));
+    b.add(b.activators, make_option<wf::activatorbinding_t>("<super>"));
+    b.add(b.keys, make_option<wf::keybinding_t>("<super> KEY_E"));
+
+    auto& e = b.index.find_key(key("<super> KEY_E"));
+    REQUIRE(e.bindings.size() == 1);
+    REQUIRE(e.activators.size() == 1);
+    REQUIRE(e.activators[0] == b.activators[0].get());
+
+    auto& right = b.index.find_button(button("<super> BTN_RIGHT"));
+    REQUIRE(right.activators.size() == 1);
+    REQUIRE(right.activators[0] == b.activators[0].get());
+
+    auto& mod = b.index.find_key(key("<super>"));
+    REQUIRE(mod.activators.size() == 1);
+    REQUIRE(mod.activators[0] == b.activators[1].get());
+}
+
+TEST_CASE("Binding index is rebuilt after invalidation")
+{
+    bindings_t b;
+    auto opt = make_option<wf::keybinding_t>("<super> KEY_A");
+    b.add(b.keys, opt);
+    REQUIRE(b.index.find_key(key("<super> KEY_A")).bindings.size() == 1);
+
+    opt->set_value(key("<super> KEY_B"));
+    b.index.invalidate();
+    REQUIRE(b.index.find_key(key("<super> KEY_A")).bindings.empty());
+    REQUIRE(b.index.find_key(key("<super> KEY_B")).bindings.size() == 1);
+
+    b.keys.clear();
+    b.index.invalidate();
+    REQUIRE(b.index.find_key(key("<super> KEY_B")).bindings.empty());
+}
+
+TEST_CASE("Benchmark: key lookup with many bindings")
+{
+    static constexpr int NR_QUERIES = 100000;
+    using namespace std::chrono;
+
+    for (int nr_bindings : {10, 1000})
+    {
+        bindings_t b;
+        for (int i = 0; i < nr_bindings; i++)
+        {
+            // Spread the bindings over different keys and modifiers
+            auto value = wf::keybinding_t{(uint32_t)(i / 200), (uint32_t)(1 + i % 200)};
+            b.add(b.keys, std::make_shared<wf::config::option_t<wf::keybinding_t>>("test", value));
+            b.add(b.activators, make_option<wf::activatorbinding_t>("<super> KEY_" + std::to_string(i % 10)));
+        }
+
+        size_t found = 0;
+        auto start   = steady_clock::now();
+        for (int i = 0; i < NR_QUERIES; i++)
+        {
+            found += b.index.find_key(wf::keybinding_t{0, (uint32_t)(1 + i % 200)}).bindings.size();
+        }
+
+        auto elapsed = duration_cast<nanoseconds>(steady_clock::now() - start).count();
+        REQUIRE(found > 0);
+        MESSAGE("key lookup with " << nr_bindings << " bindings: " << elapsed / NR_QUERIES << "ns");
+    }
+}
@@ -0,0 +1,272 @@
+#include <wayfire/scene.hpp>
+#include <wayfire/unstable/translation-node.hpp>
+#include <wayfire/view-transform.hpp>
+#include "core/core-impl.hpp"
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+#include <chrono>
+#include <random>
+
+// A view-like leaf node which accepts input everywhere inside its geometry.
+class box_node_t : public wf::scene::node_t
+{
+  public:
+    wf::geometry_t geometry;
+
+    box_node_t(wf::geometry_t geometry) : node_t(false)
+    {
+        this->geometry = geometry;
+    }
+
+    std::optional<wf::scene::input_node_t> find_node_at(const wf::pointf_t& at) override
+    {
+        if (geometry & at)
+        {
+            return wf::scene::input_node_t{
+                .node = this,
+                .local_coords = {at.x - geometry.x, at.y - geometry.y},
+            };
+        }
+
+        return {};
+    }
+
+    wf::geometry_t get_bounding_box() override
+    {
+        return geometry;
+    }
+};
+
+// A transformer which moves its children, and which is changed directly, like the transformers of animations.
+class shift_transformer_t : public wf::scene::transformer_base_node_t
+{
+  public:
+    wf::point_t shift = {0, 0};
+
+    shift_transformer_t() : transformer_base_node_t(false)
+    {}
+
+    wf::pointf_t to_local(const wf::pointf_t& point) override
+    {
+        return point - wf::pointf_t{shift};
+    }
+
+    wf::pointf_t to_global(const wf::pointf_t& point) override
+    {
+        return point + wf::pointf_t{shift};
+    }
+
+    wf::geometry_t get_bounding_box() override
+    {
+        return get_children_bounding_box() + shift;
+    }
+};
+
+static std::vector<wf::geometry_t> make_geometries(int count, std::mt19937& gen)
+{
+    std::uniform_int_distribution<int> pos(-200, 3800);
+    std::uniform_int_distribution<int> size(100, 800);
+
+    std::vector<wf::geometry_t> geometries;
+    for (int i = 0; i < count; i++)
+    {
+        geometries.push_back({pos(gen), pos(gen), size(gen), size(gen)});
+    }
+
+    return geometries;
+}
+
+static std::vector<wf::scene::node_ptr> make_boxes(const std::vector<wf::geometry_t>& geometries)
+{
+    std::vector<wf::scene::node_ptr> boxes;
+    for (auto& g : geometries)
+    {
+        boxes.push_back(std::make_shared<box_node_t>(g));
+    }
+
+    return boxes;
+}
+
+static wf::scene::node_t *find(wf::scene::node_ptr root, wf::pointf_t at)
+{
+    auto result = root->find_node_at(at);
+    return result.has_value() ? result->node.get() : nullptr;
+}
+
+// The position of the child of @root containing the found node, or -1 if nothing was found.
+static int find_index(wf::scene::node_ptr root, wf::pointf_t at)
+{
+    auto node = find(root, at);
+    while (node && (node->parent() != root.get()))
+    {
+        node = node->parent();
+    }
+
+    auto& children = root->get_children();
+    for (size_t i = 0; i < children.size(); i++)
+    {
+        if (children[i].get() == node)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+// wf::scene::update() compares the changed node with the scenegraph root, so a core instance is needed. It is
+// never initialized, and the test scenes are not attached to its root.
+static void ensure_core()
+{
+    static bool allocated = false;
+    if (!allocated)
+    {
+        wf::compositor_core_impl_t::allocate_core();
+        allocated = true;
+    }
+}
+
+TEST_CASE("Spatial index finds the same nodes as a linear search")
+{
+    using namespace wf::scene;
+    ensure_core();
+
+    std::mt19937 gen(1234);
+    auto geometries = make_geometries(300, gen);
+
+    // The same scene twice: once with the index, which is kept up to date only through scene::update(), and
+    // once without, as a reference.
+    auto root = std::make_shared<translation_node_t>(true);
+    root->set_offset({50, -30});
+    root->set_children_list(make_boxes(geometries));
+    root->set_spatial_index(true);
+
+    auto reference = std::make_shared<translation_node_t>(true);
+    reference->set_offset({50, -30});
+    reference->set_children_list(make_boxes(geometries));
+
+    std::uniform_real_distribution<double> point(-500, 4500);
+    auto check_random_points = [&] ()
+    {
+        for (int i = 0; i < 5000; i++)
+        {
+            wf::pointf_t at{point(gen), point(gen)};
+            REQUIRE(find_index(root, at) == find_index(reference, at));
+        }
+    };
+
+    check_random_points();
+
+    SUBCASE("Disabled nodes are skipped")
+    {
+        const int top = find_index(root, {100, 100});
+        REQUIRE(top >= 0);
+        root->get_children()[top]->set_enabled(false);
+        update(root->get_children()[top], update_flag::ENABLED);
+        reference->get_children()[top]->set_enabled(false);
+
+        REQUIRE(find_index(root, {100, 100}) != top);
+        check_random_points();
+    }
+
+    SUBCASE("Index is updated after geometry changes")
+    {
+        REQUIRE(find(root, {-1000, -1000}) == nullptr);
+        for (auto& tree : {root, reference})
+        {
+            auto box = std::dynamic_pointer_cast<box_node_t>(tree->get_children()[0]);
+            box->geometry = {-1050, -970, 10, 10};
+        }
+
+        update(root->get_children()[0], update_flag::GEOMETRY);
+        REQUIRE(find_index(root, {-1000, -1000}) == 0);
+        check_random_points();
+    }
+
+    SUBCASE("Index is updated after the children change")
+    {
+        for (auto& tree : {root, reference})
+        {
+            auto box = std::make_shared<box_node_t>(wf::geometry_t{-2050, -1970, 10, 10});
+            auto children = tree->get_children();
+            children.insert(children.begin() + 10, box);
+            tree->set_children_list(children);
+        }
+
+        update(root, update_flag::CHILDREN_LIST);
+        REQUIRE(find_index(root, {-2000, -2000}) == 10);
+        check_random_points();
+    }
+
+    SUBCASE("Children with transformers are found after the transformer changes")
+    {
+        std::vector<std::shared_ptr<shift_transformer_t>> transformers;
+        for (auto& tree : {root, reference})
+        {
+            auto transform_manager = std::make_shared<transform_manager_node_t>();
+            transform_manager->set_children_list({std::make_shared<box_node_t>(
+                wf::geometry_t{-3050, -2970, 300, 300})});
+            auto children = tree->get_children();
+            children.insert(children.begin() + 5, transform_manager);
+            tree->set_children_list(children);
+            update(tree, update_flag::CHILDREN_LIST);
+
+            auto transformer = std::make_shared<shift_transformer_t>();
+            transform_manager->add_transformer(transformer, 0);
+            transformers.push_back(transformer);
+        }
+
+        REQUIRE(find_index(root, {-3000, -2900}) == 5);
+        check_random_points();
+
+        // Move the view over the other children without scene::update(), like animations do.
+        for (auto& transformer : transformers)
+        {
+            transformer->shift = {3150, 3070};
+        }
+
+        REQUIRE(find(root, {-3000, -2900}) == nullptr);
+        REQUIRE(find_index(root, {150, 150}) == find_index(reference, {150, 150}));
+        REQUIRE(find_index(root, {150, 150}) >= 0);
+        REQUIRE(find_index(root, {150, 150}) <= 5);
+        check_random_points();
+    }
+}
+
+TEST_CASE("Benchmark: find_node_at with many views")
+{
+    static constexpr int NR_VIEWS   = 500;
+    static constexpr int NR_QUERIES = 100000;
+    using namespace std::chrono;
+
+    std::mt19937 gen(42);
+    auto root = std::make_shared<wf::scene::translation_node_t>(true);
+    root->set_children_list(make_boxes(make_geometries(NR_VIEWS, gen)));
+
+    std::uniform_real_distribution<double> point(0, 4000);
+    std::vector<wf::pointf_t> points;
+    for (int i = 0; i < NR_QUERIES; i++)
+    {
+        points.push_back({point(gen), point(gen)});
+    }
+
+    auto run_queries = [&] ()
+    {
+        size_t found = 0;
+        auto start   = steady_clock::now();
+        for (auto& at : points)
+        {
+            found += (find(root, at) != nullptr);
+        }
+
+        return std::make_pair(duration_cast<nanoseconds>(steady_clock::now() - start).count(), found);
+    };
+
+    auto [linear, linear_found] = run_queries();
+    root->set_spatial_index(true);
+    auto [indexed, indexed_found] = run_queries();
+    REQUIRE(linear_found == indexed_found);
+
+    MESSAGE("find_node_at() with " << NR_VIEWS << " views: " << linear / NR_QUERIES << "ns linear vs " <<
+        indexed / NR_QUERIES << "ns with spatial index");
+}
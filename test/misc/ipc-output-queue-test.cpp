@@ -0,0 +1,263 @@
+#include "ipc-output-queue.hpp"
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <unistd.h>
+#include <wayfire/nonstd/json.hpp>
+
+using push_result_t = wf::ipc::output_queue_t::push_result_t;
+
+struct socket_pair_t
+{
+    // server side is non-blocking, like the IPC client sockets
+    int server;
+    int client;
+
+    socket_pair_t()
+    {
+        int fds[2];
+        REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+        server = fds[0];
+        client = fds[1];
+        REQUIRE(fcntl(server, F_SETFL, O_NONBLOCK) == 0);
+    }
+
+    ~socket_pair_t()
+    {
+        close(server);
+        close(client);
+    }
+
+    // Read one message from the client side, or an empty string if none is available.
+    std::string read_message()
+    {
+        uint32_t len;
+        if (recv(client, &len, sizeof(len), MSG_DONTWAIT) != sizeof(len))
+        {
+            return "";
+        }
+
+        std::string message(len, '\0');
+        REQUIRE(recv(client, message.data(), len, MSG_WAITALL) == len);
+        return message;
+    }
+};
+
+static push_result_t push(wf::ipc::output_queue_t& queue, const std::string& message, bool droppable)
+{
+    return queue.push(std::make_shared<const std::string>(message), droppable);
+}
+
+TEST_CASE("Queued messages are written in order")
+{
+    socket_pair_t sockets;
+    wf::ipc::output_queue_t queue;
+
+    REQUIRE(push(queue, "first", false) == push_result_t::QUEUED);
+    REQUIRE(push(queue, "second", true) == push_result_t::QUEUED);
+    REQUIRE(queue.pending() == 2 * wf::ipc::output_queue_t::HEADER_LEN + strlen("first") + strlen("second"));
+
+    REQUIRE(queue.flush(sockets.server));
+    REQUIRE(queue.empty());
+    REQUIRE(sockets.read_message() == "first");
+    REQUIRE(sockets.read_message() == "second");
+    REQUIRE(sockets.read_message() == "");
+}
+
+TEST_CASE("High-water mark is enforced for stalled clients")
+{
+    socket_pair_t sockets;
+    wf::ipc::output_queue_t queue;
+    queue.high_water_mark = 64 * 1024;
+
+    // Fill the socket buffer and the queue, nobody reads on the client side.
+    const std::string event(1000, 'e');
+    while (push(queue, event, true) == push_result_t::QUEUED)
+    {
+        REQUIRE(queue.flush(sockets.server));
+    }
+
+    REQUIRE(queue.dropped == 1);
+    REQUIRE(queue.pending() > queue.high_water_mark);
+    REQUIRE(queue.pending() <= queue.high_water_mark + event.size() + wf::ipc::output_queue_t::HEADER_LEN);
+
+    // Messages which cannot be dropped are rejected too, so the caller can disconnect the client.
+    REQUIRE(push(queue, "response", false) == push_result_t::OVERFLOW);
+
+    // Once the client reads everything, messages are accepted again.
+    while (!queue.empty())
+    {
+        while (sockets.read_message() == event)
+        {}
+
+        REQUIRE(queue.flush(sockets.server));
+    }
+
+    while (sockets.read_message() == event)
+    {}
+
+    REQUIRE(push(queue, "response", false) == push_result_t::QUEUED);
+    REQUIRE(queue.flush(sockets.server));
+    REQUIRE(sockets.read_message() == "response");
+}
+
+TEST_CASE("Flushing fails once the client is gone")
+{
+    socket_pair_t sockets;
+    wf::ipc::output_queue_t queue;
+    shutdown(sockets.client, SHUT_RDWR);
+
+    REQUIRE(push(queue, "event", true) == push_result_t::QUEUED);
+    REQUIRE(!queue.flush(sockets.server));
+    REQUIRE(queue.empty());
+}
+
+TEST_CASE("Benchmark: sending events to a stalled client")
+{
+    static constexpr int NR_EVENTS = 100000;
+    using namespace std::chrono;
+
+    socket_pair_t sockets;
+    wf::ipc::output_queue_t queue;
+    queue.high_water_mark = 4 * 1024 * 1024;
+
+    // Roughly the size of a view-geometry-changed event
+    const std::string event(600, 'e');
+    auto start = steady_clock::now();
+    for (int i = 0; i < NR_EVENTS; i++)
+    {
+        push(queue, event, true);
+        REQUIRE(queue.flush(sockets.server));
+    }
+
+    auto total = duration_cast<nanoseconds>(steady_clock::now() - start).count();
+    REQUIRE(queue.dropped > 0);
+    REQUIRE(queue.pending() <= queue.high_water_mark + event.size() + wf::ipc::output_queue_t::HEADER_LEN);
+
+    MESSAGE("Sending " << NR_EVENTS << " events to a stalled client: " << total / NR_EVENTS <<
+        "ns per event, " << queue.dropped << " dropped");
+}
+
+TEST_CASE("Shared messages are written to every client")
+{
+    socket_pair_t first, second;
+    wf::ipc::output_queue_t first_queue, second_queue;
+
+    auto message = std::make_shared<const std::string>("event");
+    REQUIRE(first_queue.push(message, true) == push_result_t::QUEUED);
+    REQUIRE(second_queue.push(message, true) == push_result_t::QUEUED);
+    REQUIRE(message.use_count() == 3);
+
+    REQUIRE(first_queue.flush(first.server));
+    REQUIRE(second_queue.flush(second.server));
+    REQUIRE(message.use_count() == 1);
+    REQUIRE(first.read_message() == "event");
+    REQUIRE(second.read_message() == "event");
+}
+
+// An IPC client which queues messages like wf::ipc::client_t, and which reads its messages immediately.
+class queue_client_t : public wf::ipc::client_interface_t
+{
+  public:
+    wf::ipc::output_queue_t queue;
+
+    bool send_json(wf::json_t json) override
+    {
+        return send_serialized(wf::ipc::serialize_message(json));
+    }
+
+    bool send_serialized(const wf::ipc::serialized_message_t& message) override
+    {
+        bool queued = (queue.push(message, true) == push_result_t::QUEUED);
+        queue.clear();
+        return queued;
+    }
+};
+
+static wf::json_t geometry_to_json(int x, int y, int width, int height)
+{
+    wf::json_t geometry;
+    geometry["x"]     = x;
+    geometry["y"]     = y;
+    geometry["width"] = width;
+    geometry["height"] = height;
+    return geometry;
+}
+
+// An event with the same structure as the view-geometry-changed events sent by ipc-rules.
+static wf::json_t make_geometry_changed_event(int i)
+{
+    wf::json_t view;
+    view["id"]     = i;
+    view["pid"]    = 1000 + i;
+    view["title"]  = "Terminal - ~/src/wayfire";
+    view["app-id"] = "org.wayfire.terminal";
+    view["base-geometry"] = geometry_to_json(i, i, 800, 600);
+    view["parent"]   = -1;
+    view["geometry"] = geometry_to_json(i, i, 800, 600);
+    view["bbox"]     = geometry_to_json(i - 10, i - 10, 820, 620);
+    view["output-id"]   = 1;
+    view["output-name"] = "DP-1";
+    view["last-focus-timestamp"] = (int64_t)i * 1000;
+    view["role"]   = "toplevel";
+    view["mapped"] = true;
+    view["layer"]  = "workspace";
+    view["tiled-edges"] = 0;
+    view["fullscreen"]  = false;
+    view["minimized"]   = false;
+    view["activated"]   = true;
+    view["sticky"]     = false;
+    view["wset-index"] = 1;
+
+    wf::json_t event;
+    event["event"] = "view-geometry-changed";
+    event["old-geometry"] = geometry_to_json(i - 1, i - 1, 800, 600);
+    event["view"] = view;
+    return event;
+}
+
+TEST_CASE("Benchmark: IPC event fan-out")
+{
+    static constexpr int NR_EVENTS = 10000;
+    using namespace std::chrono;
+
+    std::vector<wf::json_t> events;
+    for (int i = 0; i < NR_EVENTS; i++)
+    {
+        events.push_back(make_geometry_changed_event(i));
+    }
+
+    for (int nr_clients : {1, 4, 16})
+    {
+        std::vector<queue_client_t> clients(nr_clients);
+
+        auto start = steady_clock::now();
+        for (auto& event : events)
+        {
+            for (auto& client : clients)
+            {
+                client.send_json(event);
+            }
+        }
+
+        auto per_client = duration_cast<microseconds>(steady_clock::now() - start).count();
+
+        start = steady_clock::now();
+        for (auto& event : events)
+        {
+            auto message = wf::ipc::serialize_message(event);
+            for (auto& client : clients)
+            {
+                client.send_serialized(message);
+            }
+        }
+
+        auto shared = duration_cast<microseconds>(steady_clock::now() - start).count();
+        MESSAGE(NR_EVENTS << " view-geometry-changed events to " << nr_clients << " clients: " <<
+            per_client / 1000 << "ms serializing for each client vs " << shared / 1000 <<
+            "ms serializing once");
+    }
+}
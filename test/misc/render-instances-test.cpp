@@ -0,0 +1,357 @@
+#include <wayfire/scene.hpp>
+#include <wayfire/scene-render.hpp>
+#include <wayfire/unstable/translation-node.hpp>
+#include <wayfire/output.hpp>
+#include <wayfire/workspace-stream.hpp>
+#include "core/core-impl.hpp"
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+#include <algorithm>
+#include <chrono>
+
+static int generated = 0;
+
+// A surface-like leaf node which counts how many times its render instances are generated.
+class counting_node_t : public wf::scene::node_t
+{
+  public:
+    counting_node_t() : node_t(false)
+    {}
+
+    int nr_generated = 0;
+    void gen_render_instances(std::vector<wf::scene::render_instance_uptr>& instances,
+        wf::scene::damage_callback push_damage, wf::output_t *output) override
+    {
+        ++generated;
+        ++nr_generated;
+        node_t::gen_render_instances(instances, push_damage, output);
+    }
+};
+
+static constexpr int SURFACES_PER_VIEW = 3;
+
+static std::shared_ptr<wf::scene::translation_node_t> make_view()
+{
+    auto view = std::make_shared<wf::scene::translation_node_t>();
+    std::vector<wf::scene::node_ptr> surfaces;
+    for (int i = 0; i < SURFACES_PER_VIEW; i++)
+    {
+        surfaces.push_back(std::make_shared<counting_node_t>());
+    }
+
+    view->set_children_list(surfaces);
+    return view;
+}
+
+// wf::scene::update() compares the changed node with the scenegraph root, so a core instance is needed. It is
+// never initialized, and the test scenes are not attached to its root unless installed with set_core_scene().
+static void ensure_core()
+{
+    static bool allocated = false;
+    if (!allocated)
+    {
+        wf::compositor_core_impl_t::allocate_core();
+        allocated = true;
+    }
+}
+
+// compositor_core_impl_t::init() creates the scenegraph root together with the rest of the core, so tests which
+// need a root install one themselves.
+struct core_scene_access_t : public wf::compositor_core_impl_t
+{
+    static void set_core_scene(std::shared_ptr<wf::scene::root_node_t> root)
+    {
+        auto scene_root = &core_scene_access_t::scene_root;
+        wf::get_core_impl().*scene_root = root;
+    }
+};
+
+// An output which only has a size, enough for workspace streams to collect its output nodes.
+class fake_output_t : public wf::output_t
+{
+  public:
+    std::shared_ptr<wf::workspace_set_t> wset() override
+    {
+        return nullptr;
+    }
+
+    void set_workspace_set(std::shared_ptr<wf::workspace_set_t>) override
+    {}
+
+    wf::dimensions_t get_screen_size() const override
+    {
+        return {1920, 1080};
+    }
+
+    std::shared_ptr<wf::scene::output_node_t> node_for_layer(wf::scene::layer) const override
+    {
+        return nullptr;
+    }
+
+    bool can_activate_plugin(wf::plugin_activation_data_t*, uint32_t) override
+    {
+        return false;
+    }
+
+    bool can_activate_plugin(uint32_t, uint32_t) override
+    {
+        return false;
+    }
+
+    bool activate_plugin(wf::plugin_activation_data_t*, uint32_t) override
+    {
+        return false;
+    }
+
+    bool deactivate_plugin(wf::plugin_activation_data_t*) override
+    {
+        return false;
+    }
+
+    void cancel_active_plugins() override
+    {}
+
+    bool is_plugin_active(std::string) const override
+    {
+        return false;
+    }
+
+    void add_key(wf::option_sptr_t<wf::keybinding_t>, wf::key_callback*) override
+    {}
+    void add_axis(wf::option_sptr_t<wf::keybinding_t>, wf::axis_callback*) override
+    {}
+    void add_button(wf::option_sptr_t<wf::buttonbinding_t>, wf::button_callback*) override
+    {}
+    void add_activator(wf::option_sptr_t<wf::activatorbinding_t>, wf::activator_callback*) override
+    {}
+    void rem_binding(void*) override
+    {}
+};
+
+// A structure node which records the update flags propagated to it.
+class recording_node_t : public wf::scene::translation_node_t
+{
+  public:
+    recording_node_t() : translation_node_t(true)
+    {}
+
+    uint32_t last_flags = 0;
+    uint32_t optimize_update(uint32_t flags) override
+    {
+        last_flags = flags;
+        return translation_node_t::optimize_update(flags);
+    }
+};
+
+// A synthetic scene: a root with several workspace-set-like groups, each containing many views.
+struct test_scene_t
+{
+    std::shared_ptr<recording_node_t> root;
+    std::vector<std::shared_ptr<wf::scene::translation_node_t>> groups;
+
+    test_scene_t(int nr_groups, int views_per_group)
+    {
+        ensure_core();
+        root = std::make_shared<recording_node_t>();
+        std::vector<wf::scene::node_ptr> root_children;
+        for (int i = 0; i < nr_groups; i++)
+        {
+            auto group = std::make_shared<wf::scene::translation_node_t>(true);
+            std::vector<wf::scene::node_ptr> views;
+            for (int j = 0; j < views_per_group; j++)
+            {
+                views.push_back(make_view());
+            }
+
+            group->set_children_list(views);
+            groups.push_back(group);
+            root_children.push_back(group);
+        }
+
+        root->set_children_list(root_children);
+    }
+};
+
+static void map_view(std::shared_ptr<wf::scene::translation_node_t> group,
+    std::shared_ptr<wf::scene::translation_node_t> view)
+{
+    auto children = group->get_children();
+    children.insert(children.begin(), view);
+    group->set_children_list(children);
+    wf::scene::update(group, wf::scene::update_flag::CHILDREN_LIST);
+}
+
+static void unmap_view(std::shared_ptr<wf::scene::translation_node_t> group,
+    std::shared_ptr<wf::scene::translation_node_t> view)
+{
+    auto children = group->get_children();
+    children.erase(std::find(children.begin(), children.end(), view));
+    group->set_children_list(children);
+    wf::scene::update(group, wf::scene::update_flag::CHILDREN_LIST);
+}
+
+TEST_CASE("Only instances of changed children are regenerated")
+{
+    using namespace wf::scene;
+    test_scene_t scene{4, 50};
+
+    std::vector<render_instance_uptr> instances;
+    generated = 0;
+    scene.root->gen_render_instances(instances, [] (auto) {}, nullptr);
+    REQUIRE(generated == 4 * 50 * SURFACES_PER_VIEW);
+
+    // Map a new view. The group regenerates its instances locally, so the change reaches the root only as
+    // a geometry change.
+    auto view = make_view();
+    const auto group_generation = scene.groups[1]->get_instances_generation();
+    generated = 0;
+    map_view(scene.groups[1], view);
+    REQUIRE(generated == SURFACES_PER_VIEW);
+    REQUIRE(scene.groups[1]->get_instances_generation() == group_generation);
+    REQUIRE((scene.root->last_flags & update_flag::GEOMETRY));
+    REQUIRE(!(scene.root->last_flags & update_flag::CHILDREN_LIST));
+
+    // Restack the views in the group
+    generated = 0;
+    auto children = scene.groups[1]->get_children();
+    std::reverse(children.begin(), children.end());
+    scene.groups[1]->set_children_list(children);
+    update(scene.groups[1], update_flag::CHILDREN_LIST);
+    REQUIRE(generated == 0);
+
+    // Disable and enable the view
+    auto view_generation = view->get_instances_generation();
+    generated = 0;
+    view->set_enabled(false);
+    update(view, update_flag::ENABLED);
+    REQUIRE(generated == 0);
+    REQUIRE(view->get_instances_generation() > view_generation);
+
+    view_generation = view->get_instances_generation();
+    view->set_enabled(true);
+    update(view, update_flag::ENABLED);
+    REQUIRE(generated == SURFACES_PER_VIEW);
+    REQUIRE(view->get_instances_generation() > view_generation);
+
+    // Unmap the view
+    generated = 0;
+    unmap_view(scene.groups[1], view);
+    REQUIRE(generated == 0);
+}
+
+TEST_CASE("Children whose instances cannot be updated locally are regenerated by their parent")
+{
+    using namespace wf::scene;
+    test_scene_t scene{2, 10};
+
+    // A plain inner node flattens the instances of its children into its parent's list, so it cannot
+    // update them by itself.
+    auto container = std::make_shared<floating_inner_node_t>(false);
+    container->set_children_list({std::make_shared<counting_node_t>(), std::make_shared<counting_node_t>()});
+    auto children = scene.groups[0]->get_children();
+    children.push_back(container);
+    scene.groups[0]->set_children_list(children);
+
+    std::vector<render_instance_uptr> instances;
+    scene.root->gen_render_instances(instances, [] (auto) {}, nullptr);
+
+    auto children_of_container = container->get_children();
+    children_of_container.push_back(std::make_shared<counting_node_t>());
+    container->set_children_list(children_of_container);
+
+    const auto generation = container->get_instances_generation();
+    generated = 0;
+    update(container, update_flag::CHILDREN_LIST);
+    REQUIRE(container->get_instances_generation() > generation);
+    REQUIRE(generated == 3);
+}
+
+TEST_CASE("Workspace streams follow output nodes being disabled and enabled")
+{
+    using namespace wf::scene;
+    ensure_core();
+    auto root = std::make_shared<root_node_t>();
+    core_scene_access_t::set_core_scene(root);
+
+    fake_output_t output;
+    auto top = std::make_shared<output_node_t>(&output);
+    auto top_child = std::make_shared<counting_node_t>();
+    top->set_children_list({top_child, std::make_shared<counting_node_t>()});
+    root->layers[(size_t)layer::TOP]->set_children_list({top});
+
+    auto workspace = std::make_shared<output_node_t>(&output);
+    workspace->set_children_list({std::make_shared<counting_node_t>()});
+    root->layers[(size_t)layer::WORKSPACE]->set_children_list({workspace});
+
+    int damaged = 0;
+    std::vector<render_instance_uptr> instances;
+    auto stream = std::make_shared<wf::workspace_stream_node_t>(&output, wf::point_t{0, 0});
+    generated = 0;
+    stream->gen_render_instances(instances, [&] (auto) { ++damaged; }, &output);
+    REQUIRE(generated == 3);
+
+    // Disabling the output node is handled by its layer node, and does not reach the root as a change of the
+    // children, so the stream has to notice it by itself.
+    generated = 0;
+    damaged   = 0;
+    top->set_enabled(false);
+    update(top, update_flag::ENABLED);
+    REQUIRE(generated == 1);
+    REQUIRE(damaged > 0);
+
+    generated = 0;
+    damaged   = 0;
+    top->set_enabled(true);
+    update(top, update_flag::ENABLED);
+    REQUIRE(generated == 3);
+    REQUIRE(damaged > 0);
+
+    // The re-enabled output node is tracked again.
+    auto new_child = std::make_shared<counting_node_t>();
+    top->set_children_list({new_child, top_child});
+    update(top, update_flag::CHILDREN_LIST);
+    REQUIRE(new_child->nr_generated > 0);
+
+    instances.clear();
+    core_scene_access_t::set_core_scene(nullptr);
+}
+
+TEST_CASE("Benchmark: map and unmap views in a large scene")
+{
+    static constexpr int NR_GROUPS = 8;
+    static constexpr int VIEWS_PER_GROUP = 100;
+    static constexpr int ITERATIONS = 200;
+    using namespace std::chrono;
+
+    test_scene_t scene{NR_GROUPS, VIEWS_PER_GROUP};
+    std::vector<wf::scene::render_instance_uptr> instances;
+    scene.root->gen_render_instances(instances, [] (auto) {}, nullptr);
+
+    auto view = make_view();
+    generated = 0;
+    auto start = steady_clock::now();
+    for (int i = 0; i < ITERATIONS; i++)
+    {
+        map_view(scene.groups[i % NR_GROUPS], view);
+        unmap_view(scene.groups[i % NR_GROUPS], view);
+    }
+
+    auto incremental = duration_cast<microseconds>(steady_clock::now() - start).count();
+    REQUIRE(generated == ITERATIONS * SURFACES_PER_VIEW);
+
+    // Compare with regenerating all instances on every change, as happens for changes which reach the root.
+    generated = 0;
+    start = steady_clock::now();
+    for (int i = 0; i < ITERATIONS; i++)
+    {
+        for (int j = 0; j < 2; j++)
+        {
+            instances.clear();
+            scene.root->gen_render_instances(instances, [] (auto) {}, nullptr);
+        }
+    }
+
+    auto full = duration_cast<microseconds>(steady_clock::now() - start).count();
+    MESSAGE("Map+unmap of a view in a scene with " << NR_GROUPS * VIEWS_PER_GROUP << " views: " <<
+        incremental / ITERATIONS << "us incremental vs " << full / ITERATIONS << "us full regeneration");
+}
@@ -0,0 +1,131 @@
+#include <wayfire/signal-provider.hpp>
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+#include <chrono>
+
+struct signal_a_t
+{
+    int value = 0;
+};
+
+struct signal_b_t
+{
+    int value = 0;
+};
+
+TEST_CASE("Signals are dispatched only to connections of the same type")
+{
+    wf::signal::provider_t provider;
+    int a_calls = 0, b_calls = 0;
+
+    wf::signal::connection_t<signal_a_t> on_a = [&] (signal_a_t *ev) { a_calls += ev->value; };
+    wf::signal::connection_t<signal_b_t> on_b = [&] (signal_b_t *ev) { b_calls += ev->value; };
+
+    signal_a_t a{1};
+    signal_b_t b{10};
+
+    // No connections at all
+    provider.emit(&a);
+    REQUIRE(a_calls == 0);
+
+    provider.connect(&on_a);
+    provider.emit(&a);
+    provider.emit(&b);
+    REQUIRE(a_calls == 1);
+    REQUIRE(b_calls == 0);
+
+    provider.connect(&on_b);
+    provider.emit(&b);
+    REQUIRE(a_calls == 1);
+    REQUIRE(b_calls == 10);
+
+    on_a.disconnect();
+    REQUIRE(!on_a.is_connected());
+    provider.emit(&a);
+    provider.emit(&b);
+    REQUIRE(a_calls == 1);
+    REQUIRE(b_calls == 20);
+}
+
+TEST_CASE("Connections can be changed during emission")
+{
+    wf::signal::provider_t provider;
+    int first_calls = 0, second_calls = 0, late_calls = 0;
+
+    wf::signal::connection_t<signal_a_t> late = [&] (signal_a_t*) { late_calls++; };
+    wf::signal::connection_t<signal_a_t> second = [&] (signal_a_t*) { second_calls++; };
+    wf::signal::connection_t<signal_a_t> first = [&] (signal_a_t*)
+    {
+        first_calls++;
+        // Disconnecting a connection which was not yet called prevents it from being called, and connections
+        // added during the emission are called only from the next emission.
+        second.disconnect();
+        provider.connect(&late);
+    };
+
+    provider.connect(&first);
+    provider.connect(&second);
+
+    signal_a_t a;
+    provider.emit(&a);
+    REQUIRE(first_calls == 1);
+    REQUIRE(second_calls == 0);
+    REQUIRE(late_calls == 0);
+
+    first.disconnect();
+    provider.emit(&a);
+    REQUIRE(first_calls == 1);
+    REQUIRE(late_calls == 1);
+}
+
+TEST_CASE("Connections are disconnected when the provider is destroyed")
+{
+    wf::signal::connection_t<signal_a_t> on_a = [&] (signal_a_t*) {};
+    {
+        wf::signal::provider_t provider;
+        provider.connect(&on_a);
+        REQUIRE(on_a.is_connected());
+    }
+
+    REQUIRE(!on_a.is_connected());
+}
+
+TEST_CASE("Benchmark: signal emission")
+{
+    static constexpr int NR_EMITS = 1000000;
+    using namespace std::chrono;
+
+    auto measure = [] (wf::signal::provider_t& provider)
+    {
+        signal_a_t a;
+        auto start = steady_clock::now();
+        for (int i = 0; i < NR_EMITS; i++)
+        {
+            provider.emit(&a);
+        }
+
+        return duration_cast<nanoseconds>(steady_clock::now() - start).count() / (double)NR_EMITS;
+    };
+
+    wf::signal::provider_t provider;
+    const double no_connections = measure(provider);
+
+    // Connections to other signals which are not emitted
+    wf::signal::connection_t<signal_b_t> on_b = [&] (signal_b_t*) {};
+    provider.connect(&on_b);
+
+    int calls = 0;
+    std::vector<std::unique_ptr<wf::signal::connection_t<signal_a_t>>> connections;
+    for (int i = 0; i < 4; i++)
+    {
+        connections.push_back(std::make_unique<wf::signal::connection_t<signal_a_t>>(
+            [&] (signal_a_t*) { calls++; }));
+        provider.connect(connections.back().get());
+    }
+
+    const double four_connections = measure(provider);
+    REQUIRE(calls == 4 * NR_EMITS);
+
+    MESSAGE("Signal emission: " << no_connections << "ns without connections, " <<
+        four_connections << "ns with 4 connections");
+}
@@ -10,6 +10,7 @@
 #include "transaction-test-object.hpp"
 #include <wayfire/txn/transaction.hpp>
 #include "../../src/core/txn/transaction-manager-impl.hpp"
+#include <chrono>
 
 static wf::txn::transaction_uptr new_tx()
 {
@@ -290,3 +291,67 @@ TEST_CASE("Concurrent committed")
     REQUIRE(mgr.pending.size() == 0);
     REQUIRE(mgr.done.size() == 2);
 }
+
+TEST_CASE("Benchmark: merging many overlapping transactions")
+{
+    setup_wayfire_debugging_state();
+    // Logging each added object would dominate the measurements.
+    const auto saved_categories = wf::log::enabled_categories;
+    wf::log::enabled_categories.set((size_t)wf::log::logging_category::TXN, 0);
+    wf::log::enabled_categories.set((size_t)wf::log::logging_category::TXNI, 0);
+    using namespace std::chrono;
+
+    // Emulate tiling a workspace: a large transaction for all windows is committed, and while it is in
+    // progress, many small transactions for pairs of neighboring windows arrive and need to be merged.
+    auto run = [] (int nr_windows)
+    {
+        wf::txn::transaction_manager_t::impl mgr;
+        std::vector<std::shared_ptr<txn_test_object_t>> windows;
+        auto tile_all = new_tx();
+        for (int i = 0; i < nr_windows; i++)
+        {
+            windows.push_back(std::make_shared<txn_test_object_t>(false));
+            tile_all->add_object(windows.back());
+        }
+
+        auto start = steady_clock::now();
+        mgr.schedule_transaction(std::move(tile_all));
+        for (int i = 0; i + 1 < nr_windows; i++)
+        {
+            auto resize_pair = new_tx();
+            resize_pair->add_object(windows[i]);
+            resize_pair->add_object(windows[i + 1]);
+            mgr.schedule_transaction(std::move(resize_pair));
+        }
+
+        auto elapsed = duration_cast<nanoseconds>(steady_clock::now() - start).count();
+        REQUIRE(mgr.committed.size() == 1);
+        REQUIRE(mgr.pending.size() == 1);
+        REQUIRE(mgr.pending.front()->get_objects().size() == (size_t)nr_windows);
+
+        for (auto& window : windows)
+        {
+            window->emit_ready();
+        }
+
+        REQUIRE(mgr.committed.size() == 1);
+        REQUIRE(mgr.pending.size() == 0);
+        for (auto& window : windows)
+        {
+            REQUIRE(window->number_committed == 2);
+        }
+
+        return elapsed;
+    };
+
+    // Each pair is merged into the transaction which already contains the previous pairs, so the time per
+    // transaction should stay roughly the same as the number of windows grows.
+    for (int nr_windows : {100, 1000, 4000, 16000})
+    {
+        auto elapsed = run(nr_windows);
+        MESSAGE("Scheduling " << nr_windows << " overlapping transactions took " << elapsed / 1000 << "us, " <<
+            elapsed / nr_windows << "ns per transaction");
+    }
+
+    wf::log::enabled_categories = saved_categories;
+}